@@ -105,6 +105,69 @@ void analogWrite(dac_channel_t dac_channel, int value);
 void analogWriteResolution(int resolution);
 void analogReadResolution(int resolution);
 
+/***************************************************************************//**
+ * Sets the number of ADC conversions averaged by the hardware for each analogRead()
+ *
+ * Averaging in hardware is much faster than calling analogRead() multiple times.
+ * Combine it with analogReadResolution() above 12 bits for the most stable readings.
+ *
+ * @param[in] samples The number of averaged conversions - rounded down to 1, 2, 4, 8 or 16
+ ******************************************************************************/
+void analogReadAveraging(int samples);
+
+/***************************************************************************//**
+ * Reads the voltage on an analog pin in millivolts
+ *
+ * The conversion uses the factory calibration of the ADC and integer math only.
+ * With the VDD references the supply is measured against the internal bandgap
+ * reference instead of assuming 3.3V. The measurement is cached, call
+ * analogReferenceUpdate() to measure it again.
+ *
+ * @param[in] pin The selected analog input pin
+ *
+ * @return the measured voltage in millivolts
+ ******************************************************************************/
+int analogReadMillivolts(pin_size_t pin);
+int analogReadMillivolts(PinName pin);
+
+/***************************************************************************//**
+ * Measures the supply voltage used by the AR_VDD and AR_08VDD references again
+ *
+ * Call it when the supply may have changed since the ADC was started
+ * (e.g. on battery powered boards). A running ADC scan is restarted.
+ ******************************************************************************/
+void analogReferenceUpdate();
+
+/***************************************************************************//**
+ * Reads the difference between two analog pins
+ *
+ * One of the pins has to be even and the other odd numbered within their ports
+ * (e.g. PB0 and PB1). The result is signed, its full scale is the reference
+ * voltage divided by the gain in both directions.
+ *
+ * @param[in] positive_pin The positive analog input pin
+ * @param[in] negative_pin The negative analog input pin
+ * @param[in] gain The analog gain - one of AG_0P5X, AG_1X, AG_2X, AG_3X, AG_4X
+ *
+ * @return the signed ADC reading in the analogReadResolution(), 0 for an invalid pin pair
+ ******************************************************************************/
+int analogReadDifferential(pin_size_t positive_pin, pin_size_t negative_pin, uint8_t gain = AG_1X);
+int analogReadDifferential(PinName positive_pin, PinName negative_pin, uint8_t gain = AG_1X);
+
+/***************************************************************************//**
+ * Reads the voltage between two analog pins in millivolts
+ *
+ * Same as analogReadDifferential() but calibrated to millivolts with integer math.
+ *
+ * @param[in] positive_pin The positive analog input pin
+ * @param[in] negative_pin The negative analog input pin
+ * @param[in] gain The analog gain - one of AG_0P5X, AG_1X, AG_2X, AG_3X, AG_4X
+ *
+ * @return the measured voltage in millivolts, 0 for an invalid pin pair
+ ******************************************************************************/
+int analogReadDifferentialMillivolts(pin_size_t positive_pin, pin_size_t negative_pin, uint8_t gain = AG_1X);
+int analogReadDifferentialMillivolts(PinName positive_pin, PinName negative_pin, uint8_t gain = AG_1X);
+
 /***************************************************************************//**
  * Starts continuous ADC sample acquisition using DMA
  *
@@ -117,6 +180,105 @@ void analogReadResolution(int resolution);
 void analogReadDMA(PinName pin, uint32_t *buffer, uint32_t size, void (*user_onsampling_finished_callback)());
 void analogReadDMA(pin_size_t pin, uint32_t *buffer, uint32_t size, void (*user_onsampling_finished_callback)());
 
+/***************************************************************************//**
+ * Starts continuous ADC sample acquisition using DMA into a 16-bit buffer
+ *
+ * Every sample takes two bytes instead of four, so the same amount of memory
+ * holds twice as many samples. All the analogReadDMA() variants below accept
+ * either 32-bit or 16-bit buffers.
+ *
+ * @param[in] pin The selected analog input pin
+ * @param[in] buffer Pointer to the sampling buffer
+ * @param[in] size The number of samples in the sampling buffer
+ * @param[in] user_onsampling_finished_callback Callback that gets called when an
+ *            acquisition finishes - pass 'nullptr' to stop sampling
+ ******************************************************************************/
+void analogReadDMA(PinName pin, uint16_t *buffer, uint32_t size, void (*user_onsampling_finished_callback)());
+void analogReadDMA(pin_size_t pin, uint16_t *buffer, uint32_t size, void (*user_onsampling_finished_callback)());
+
+/***************************************************************************//**
+ * Starts ADC sample acquisition using DMA at a fixed sample rate
+ *
+ * The conversions are paced by a hardware timer, so the samples are equally
+ * spaced in time. The rate is derived from the ADC clock with an integer
+ * divider - the returned value is the rate actually achieved.
+ * analogRead() can be called while the acquisition runs - the single
+ * conversions run between the timer triggers and the DMA is not paused.
+ *
+ * @param[in] pin The selected analog input pin
+ * @param[in] buffer Pointer to the sampling buffer
+ * @param[in] size The size of the sampling buffer
+ * @param[in] sample_rate_hz The requested sample rate in Hz
+ * @param[in] user_onsampling_finished_callback Callback that gets called when an
+ *            acquisition finishes - pass 'nullptr' to stop sampling
+ *
+ * @return the achieved sample rate in Hz, 0 if the sampling could not be started
+ ******************************************************************************/
+float analogReadDMA(PinName pin, uint32_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)());
+float analogReadDMA(pin_size_t pin, uint32_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)());
+float analogReadDMA(PinName pin, uint16_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)());
+float analogReadDMA(pin_size_t pin, uint16_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)());
+
+/***************************************************************************//**
+ * Starts ADC sample acquisition on multiple pins using DMA at a fixed sample rate
+ *
+ * All pins are sampled once per sample period and the results are stored
+ * interleaved in the buffer (pin0, pin1, ..., pin0, pin1, ...).
+ * The lowest supported rate is about 149 - 298 Hz depending on the ADC clock.
+ *
+ * @param[in] pins Array of the selected analog input pins
+ * @param[in] num_pins The number of pins in the array (max 16)
+ * @param[in] buffer Pointer to the sampling buffer
+ * @param[in] size The size of the sampling buffer - should be a multiple of 'num_pins'
+ * @param[in] sample_rate_hz The requested per pin sample rate in Hz
+ * @param[in] user_onsampling_finished_callback Callback that gets called when an
+ *            acquisition finishes - pass 'nullptr' to stop sampling
+ *
+ * @return the achieved per pin sample rate in Hz, 0 if the sampling could not be started
+ ******************************************************************************/
+float analogReadDMA(const PinName *pins, uint8_t num_pins, uint32_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)());
+float analogReadDMA(const pin_size_t *pins, uint8_t num_pins, uint32_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)());
+float analogReadDMA(const PinName *pins, uint8_t num_pins, uint16_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)());
+float analogReadDMA(const pin_size_t *pins, uint8_t num_pins, uint16_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)());
+
+/***************************************************************************//**
+ * Adds a note to the background melody queue
+ *
+ * The queued notes are played one after the other in the background, so the
+ * sketch keeps running while the melody plays. Calling tone() or noTone() on
+ * the pin playing the melody stops it.
+ *
+ * @param[in] pin The output pin of the note
+ * @param[in] frequency The frequency of the note in Hz - 0 for a rest
+ * @param[in] duration The length of the note in milliseconds
+ *
+ * @return true if the note was added, false if the queue is full
+ ******************************************************************************/
+bool toneQueue(pin_size_t pin, unsigned int frequency, unsigned long duration);
+bool toneQueue(PinName pin, unsigned int frequency, unsigned long duration);
+
+/***************************************************************************//**
+ * Returns the number of notes left in the melody queue
+ *
+ * @return the number of queued notes including the one playing
+ ******************************************************************************/
+size_t toneQueueLength();
+
+/***************************************************************************//**
+ * Stops the melody and removes all notes from the queue
+ ******************************************************************************/
+void toneQueueClear();
+
+#ifdef NUM_DAC_HW
+#include "analog_pipeline.h"
+#endif // NUM_DAC_HW
+
+#if defined(PCNT_PRESENT)
+#include "pcnt.h"
+#endif // PCNT_PRESENT
+
+#include "freq_meter.h"
+
 bool get_system_init_finished();
 uint32_t get_system_reset_cause();
 void escape_hatch();
@@ -26,6 +26,46 @@
 
 #include "Arduino.h"
 #include "pinDefinitions.h"
+#include "timers.h"
+
+// Tones with a duration are stopped from a sleeptimer, so tone() returns right away.
+// The sleeptimer callback runs in interrupt context - the PWM is stopped from the
+// FreeRTOS timer task instead, as it uses a mutex.
+
+typedef struct {
+  bool active;
+  PinName pin;
+  uint32_t generation;
+  sl_sleeptimer_timer_handle_t timer;
+} timed_tone_t;
+
+typedef struct {
+  PinName pin;
+  unsigned int frequency;
+  unsigned long duration;
+} queued_note_t;
+
+static const uint8_t max_timed_tones = 4u;
+static const uint8_t tone_queue_size = 16u;
+
+static timed_tone_t timed_tones[max_timed_tones];
+
+static queued_note_t tone_queue[tone_queue_size];
+static uint8_t tone_queue_head = 0u;
+static uint8_t tone_queue_count = 0u;
+static PinName tone_queue_pin = PIN_NAME_NC;
+static bool tone_queue_playing = false;
+static uint32_t tone_queue_generation = 0u;
+static sl_sleeptimer_timer_handle_t tone_queue_timer;
+
+static void cancel_timed_tone(PinName pin);
+static bool start_timed_tone(PinName pin, unsigned long duration);
+static void timed_tone_expired_cb(sl_sleeptimer_timer_handle_t *handle, void *data);
+static void timed_tone_end(void *param, uint32_t generation);
+static void tone_queue_cancel_on_pin(PinName pin);
+static void tone_queue_play_next();
+static void tone_queue_note_expired_cb(sl_sleeptimer_timer_handle_t *handle, void *data);
+static void tone_queue_note_end(void *param, uint32_t generation);
 
 void tone(uint8_t _pin, unsigned int frequency, unsigned long duration)
 {
@@ -38,10 +78,18 @@ void tone(uint8_t _pin, unsigned int frequency, unsigned long duration)
 
 void tone(PinName pin, unsigned int frequency, unsigned long duration)
 {
+  // A new tone replaces whatever was playing on the pin
+  tone_queue_cancel_on_pin(pin);
+  cancel_timed_tone(pin);
   PWM.frequency_mode(pin, frequency);
-  if (duration == 0) {
+  if (duration == 0 || frequency == 0) {
     return;
   }
+  if (start_timed_tone(pin, duration)) {
+    return;
+  }
+
+  // Wait for the end of the tone if it can't be timed in the background
   uint32_t tone_end_time = millis() + duration;
   while (millis() < tone_end_time) {
     yield();
@@ -60,5 +108,204 @@ void noTone(uint8_t _pin)
 
 void noTone(PinName pin)
 {
+  tone_queue_cancel_on_pin(pin);
+  cancel_timed_tone(pin);
   PWM.frequency_mode(pin, 0);
 }
+
+bool toneQueue(pin_size_t pin, unsigned int frequency, unsigned long duration)
+{
+  PinName pin_name = pinToPinName(pin);
+  if (pin_name == PIN_NAME_NC) {
+    return false;
+  }
+  return toneQueue(pin_name, frequency, duration);
+}
+
+bool toneQueue(PinName pin, unsigned int frequency, unsigned long duration)
+{
+  if (pin >= PIN_NAME_MAX || duration == 0) {
+    return false;
+  }
+
+  bool start_playing = false;
+  taskENTER_CRITICAL();
+  if (tone_queue_count == tone_queue_size) {
+    taskEXIT_CRITICAL();
+    return false;
+  }
+  uint8_t tail = (tone_queue_head + tone_queue_count) % tone_queue_size;
+  tone_queue[tail].pin = pin;
+  tone_queue[tail].frequency = frequency;
+  tone_queue[tail].duration = duration;
+  tone_queue_count++;
+  if (!tone_queue_playing) {
+    tone_queue_playing = true;
+    start_playing = true;
+  }
+  taskEXIT_CRITICAL();
+
+  if (start_playing) {
+    tone_queue_play_next();
+  }
+  return true;
+}
+
+size_t toneQueueLength()
+{
+  taskENTER_CRITICAL();
+  size_t length = tone_queue_count + (tone_queue_playing && tone_queue_pin != PIN_NAME_NC ? 1u : 0u);
+  taskEXIT_CRITICAL();
+  return length;
+}
+
+void toneQueueClear()
+{
+  (void)sl_sleeptimer_stop_timer(&tone_queue_timer);
+  taskENTER_CRITICAL();
+  PinName pin = tone_queue_pin;
+  tone_queue_count = 0u;
+  tone_queue_playing = false;
+  tone_queue_pin = PIN_NAME_NC;
+  // Invalidate the end of the note if it has already expired
+  tone_queue_generation++;
+  taskEXIT_CRITICAL();
+
+  if (pin != PIN_NAME_NC) {
+    PWM.frequency_mode(pin, 0);
+  }
+}
+
+static void cancel_timed_tone(PinName pin)
+{
+  for (auto& timed_tone : timed_tones) {
+    if (timed_tone.active && timed_tone.pin == pin) {
+      (void)sl_sleeptimer_stop_timer(&timed_tone.timer);
+      taskENTER_CRITICAL();
+      timed_tone.active = false;
+      // Invalidate the end of the tone if it has already expired
+      timed_tone.generation++;
+      taskEXIT_CRITICAL();
+    }
+  }
+}
+
+static bool start_timed_tone(PinName pin, unsigned long duration)
+{
+  for (auto& timed_tone : timed_tones) {
+    taskENTER_CRITICAL();
+    bool free = !timed_tone.active;
+    if (free) {
+      timed_tone.active = true;
+      timed_tone.pin = pin;
+    }
+    taskEXIT_CRITICAL();
+    if (!free) {
+      continue;
+    }
+    sl_status_t status = sl_sleeptimer_start_timer_ms(&timed_tone.timer, (uint32_t)duration, timed_tone_expired_cb, &timed_tone, 0u, 0u);
+    if (status == SL_STATUS_OK) {
+      return true;
+    }
+    timed_tone.active = false;
+    return false;
+  }
+  return false;
+}
+
+static void timed_tone_expired_cb(sl_sleeptimer_timer_handle_t *handle, void *data)
+{
+  timed_tone_t *timed_tone = (timed_tone_t *)data;
+  BaseType_t higher_priority_task_woken = pdFALSE;
+  if (xTimerPendFunctionCallFromISR(timed_tone_end, timed_tone, timed_tone->generation, &higher_priority_task_woken) != pdPASS) {
+    // The timer command queue is full - try again on the next sleeptimer tick
+    (void)sl_sleeptimer_start_timer(handle, 1u, timed_tone_expired_cb, data, 0u, 0u);
+    return;
+  }
+  portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+static void timed_tone_end(void *param, uint32_t generation)
+{
+  timed_tone_t *timed_tone = (timed_tone_t *)param;
+  taskENTER_CRITICAL();
+  // Skip if the tone has been replaced or stopped since it expired
+  PinName pin = PIN_NAME_NC;
+  if (timed_tone->active && timed_tone->generation == generation) {
+    pin = timed_tone->pin;
+    timed_tone->active = false;
+    timed_tone->generation++;
+  }
+  taskEXIT_CRITICAL();
+
+  if (pin != PIN_NAME_NC) {
+    PWM.frequency_mode(pin, 0);
+  }
+}
+
+static void tone_queue_cancel_on_pin(PinName pin)
+{
+  taskENTER_CRITICAL();
+  bool playing_on_pin = tone_queue_playing && tone_queue_pin == pin;
+  taskEXIT_CRITICAL();
+  if (playing_on_pin) {
+    toneQueueClear();
+  }
+}
+
+static void tone_queue_play_next()
+{
+  taskENTER_CRITICAL();
+  PinName previous_pin = tone_queue_pin;
+  if (tone_queue_count == 0u) {
+    tone_queue_playing = false;
+    tone_queue_pin = PIN_NAME_NC;
+    taskEXIT_CRITICAL();
+    // The melody has ended
+    if (previous_pin != PIN_NAME_NC) {
+      PWM.frequency_mode(previous_pin, 0);
+    }
+    return;
+  }
+  queued_note_t note = tone_queue[tone_queue_head];
+  tone_queue_head = (tone_queue_head + 1u) % tone_queue_size;
+  tone_queue_count--;
+  tone_queue_pin = note.pin;
+  uint32_t generation = tone_queue_generation;
+  taskEXIT_CRITICAL();
+
+  // A note on another pin ends the previous one
+  if (previous_pin != PIN_NAME_NC && previous_pin != note.pin) {
+    PWM.frequency_mode(previous_pin, 0);
+  }
+  // A zero frequency is a rest
+  PWM.frequency_mode(note.pin, note.frequency);
+
+  sl_status_t status = sl_sleeptimer_start_timer_ms(&tone_queue_timer, (uint32_t)note.duration, tone_queue_note_expired_cb, (void *)(uintptr_t)generation, 0u, 0u);
+  if (status != SL_STATUS_OK) {
+    toneQueueClear();
+  }
+}
+
+static void tone_queue_note_expired_cb(sl_sleeptimer_timer_handle_t *handle, void *data)
+{
+  BaseType_t higher_priority_task_woken = pdFALSE;
+  if (xTimerPendFunctionCallFromISR(tone_queue_note_end, nullptr, (uint32_t)(uintptr_t)data, &higher_priority_task_woken) != pdPASS) {
+    // The timer command queue is full - try again on the next sleeptimer tick
+    (void)sl_sleeptimer_start_timer(handle, 1u, tone_queue_note_expired_cb, data, 0u, 0u);
+    return;
+  }
+  portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+static void tone_queue_note_end(void *param, uint32_t generation)
+{
+  (void)param;
+  taskENTER_CRITICAL();
+  // Skip if the queue has been cleared since the note expired
+  bool current = tone_queue_playing && (generation == tone_queue_generation);
+  taskEXIT_CRITICAL();
+  if (current) {
+    tone_queue_play_next();
+  }
+}
@@ -30,44 +30,81 @@ using namespace arduino;
 
 static bool dma_transfer_finished_cb(unsigned int channel, unsigned int sequenceNo, void *userParam);
 
+// Analog gain settings with their ratio as a fraction, indexed by 'analog_gains'
+static const struct {
+  IADC_CfgAnalogGain_t setting;
+  uint8_t numerator;
+  uint8_t denominator;
+} analog_gain_map[AG_MAX] = {
+  { iadcCfgAnalogGain0P5x, 1u, 2u },
+  { iadcCfgAnalogGain1x, 1u, 1u },
+  { iadcCfgAnalogGain2x, 2u, 1u },
+  { iadcCfgAnalogGain3x, 3u, 1u },
+  { iadcCfgAnalogGain4x, 4u, 1u }
+};
+
 AdcClass::AdcClass() :
+  initialized_adc(false),
   initialized_single(false),
   initialized_scan(false),
   paused_transfer(false),
   current_adc_pin(PD2),
+  current_adc_negative_pin(PIN_NAME_NC),
+  current_adc_gain(AG_1X),
   current_adc_reference(AR_VDD),
-  current_read_resolution(this->max_read_resolution_bits),
+  current_read_resolution(this->native_read_resolution_bits),
+  current_read_averaging(1u),
+  single_conversion_resolution_bits(this->native_read_resolution_bits),
+  supply_millivolts(0u),
+  single_ended_millivolt_scale(0u),
+  differential_millivolt_scale(0u),
+  num_scan_pins(0u),
+  scan_sample_rate_hz(0u),
+  scan_src_clk_freq(0u),
+  scan_timer_cycles(0u),
+  scan_buffer(nullptr),
+  scan_buffer_half_words(false),
+  scan_prs_channel(-1),
+  scan_overrun_count(0u),
+  default_irq_priority(0u),
+  window_comparator_enabled(false),
+  window_comparator_armed_inside(true),
+  window_low_threshold(0u),
+  window_high_threshold(0u),
+  saved_iadc_clock(cmuSelect_FSRCO),
+  dma_channel(EMDRV_DMADRV_DMA_CH_COUNT),
   user_onsampling_finished_callback(nullptr),
+  user_window_comparator_callback(nullptr),
+  user_onsample_callback(nullptr),
   adc_mutex(nullptr)
 {
   this->adc_mutex = xSemaphoreCreateMutexStatic(&this->adc_mutex_buf);
   configASSERT(this->adc_mutex);
 }
 
-void AdcClass::init_single(PinName pin, uint8_t reference)
+sl_status_t AdcClass::prepare_configs(IADC_Init_t *init, IADC_AllConfigs_t *all_configs, IADC_InitSingle_t *init_single)
 {
-  // Set up the ADC pin as an input
-  pinMode(pin, INPUT);
+  // Shutdown between conversions to reduce current
+  init->warmup = iadcWarmupNormal;
 
-  // Create ADC init structs with default values
-  IADC_Init_t init = IADC_INIT_DEFAULT;
-  IADC_AllConfigs_t all_configs = IADC_ALLCONFIGS_DEFAULT;
-  IADC_InitSingle_t init_single = IADC_INITSINGLE_DEFAULT;
-  IADC_SingleInput_t input = IADC_SINGLEINPUT_DEFAULT;
+  if (this->window_comparator_enabled) {
+    // Arm the comparator for the next expected window transition
+    uint32_t thresholds = this->get_window_comparator_thresholds(this->window_comparator_armed_inside);
+    init->greaterThanEqualThres = (uint16_t)((thresholds & _IADC_CMPTHR_ADGT_MASK) >> _IADC_CMPTHR_ADGT_SHIFT);
+    init->lessThanEqualThres = (uint16_t)((thresholds & _IADC_CMPTHR_ADLT_MASK) >> _IADC_CMPTHR_ADLT_SHIFT);
+  }
 
-  // Enable IADC0, GPIO and PRS clock branches
-  CMU_ClockEnable(cmuClock_IADC0, true);
-  CMU_ClockEnable(cmuClock_GPIO, true);
-  CMU_ClockEnable(cmuClock_PRS, true);
+  // Set the HFSCLK prescale value here
+  init->srcClkPrescale = IADC_calcSrcClkPrescale(IADC0, this->scan_src_clk_freq_target, 0);
 
   IADC_CfgReference_t sl_adc_reference;
   uint32_t sl_adc_vref;
 
   // Set the voltage reference
-  switch (reference) {
+  switch (this->current_adc_reference) {
     case AR_INTERNAL1V2:
       sl_adc_reference = iadcCfgReferenceInt1V2;
-      sl_adc_vref = 1200;
+      sl_adc_vref = this->internal_reference_millivolts;
       break;
 
     case AR_EXTERNAL_1V25:
@@ -76,20 +113,119 @@ void AdcClass::init_single(PinName pin, uint8_t reference)
       break;
 
     case AR_VDD:
+      // Measure the actual supply voltage instead of assuming 3.3V - it's cached until update_supply_voltage()
+      if (this->supply_millivolts == 0u) {
+        this->supply_millivolts = this->measure_supply_millivolts();
+      }
       sl_adc_reference = iadcCfgReferenceVddx;
-      sl_adc_vref = 3300;
+      sl_adc_vref = this->supply_millivolts;
       break;
 
     case AR_08VDD:
+      if (this->supply_millivolts == 0u) {
+        this->supply_millivolts = this->measure_supply_millivolts();
+      }
       sl_adc_reference = iadcCfgReferenceVddX0P8Buf;
-      sl_adc_vref = 2640;
+      sl_adc_vref = (this->supply_millivolts * 4u) / 5u;
       break;
 
     default:
-      return;
+      return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  this->scan_timer_cycles = 0u;
+  this->scan_src_clk_freq = 0u;
+
+  // Set up the local IADC timer to trigger the scans at the requested rate
+  if (this->num_scan_pins > 0u && this->scan_sample_rate_hz > 0u) {
+    uint32_t sample_rate_hz = this->scan_sample_rate_hz;
+    // Slow down CLK_SRC_ADC if the timer can't count long enough for the requested rate
+    uint32_t cmu_clk_freq = CMU_ClockFreqGet(cmuClock_IADCCLK);
+    while (init->srcClkPrescale < this->max_src_clk_prescale
+           && (cmu_clk_freq / (init->srcClkPrescale + 1u)) / sample_rate_hz > _IADC_TIMER_TIMER_MASK) {
+      init->srcClkPrescale++;
+    }
+    uint32_t src_clk_freq = cmu_clk_freq / (init->srcClkPrescale + 1u);
+    // Round to the nearest achievable rate
+    uint32_t timer_cycles = (src_clk_freq + (sample_rate_hz / 2u)) / sample_rate_hz;
+
+    // The whole scan table has to be converted within one timer period
+    // CLK_ADC is at most the half of CLK_SRC_ADC, the extra microsecond covers the warmup from standby
+    uint32_t min_timer_cycles = (this->num_scan_pins * this->scan_conversion_adc_clk_cycles * 2u) + (src_clk_freq / 1000000u);
+    if (timer_cycles > _IADC_TIMER_TIMER_MASK || timer_cycles < min_timer_cycles) {
+      return SL_STATUS_INVALID_RANGE;
+    }
+
+    init->timerCycles = (uint16_t)timer_cycles;
+    // Keep the ADC in standby between the triggers so the warmup is short and constant
+    init->warmup = iadcWarmupKeepInStandby;
+    this->scan_timer_cycles = timer_cycles;
+    this->scan_src_clk_freq = src_clk_freq;
+  }
+
+  if (this->num_scan_pins > 0u && this->scan_prs_channel >= 0) {
+    // Keep the ADC in standby between the triggers so every conversion takes the same time
+    init->warmup = iadcWarmupKeepInStandby;
+  }
+
+  // The scan queue uses the first configuration, the single queue the second one
+  // Both share the voltage reference, so a single conversion can run while a scan is streaming
+  for (uint8_t i = 0u; i < IADC0_CONFIGNUM; i++) {
+    all_configs->configs[i].reference = sl_adc_reference;
+    all_configs->configs[i].vRef = sl_adc_vref;
+    all_configs->configs[i].osrHighSpeed = iadcCfgOsrHighSpeed2x;
+    all_configs->configs[i].analogGain = iadcCfgAnalogGain1x;
+
+    /*
+     * CLK_SRC_ADC must be prescaled by some value greater than 1 to
+     * derive the intended CLK_ADC frequency.
+     * Based on the default 2x oversampling rate (OSRHS)...
+     * conversion time = ((4 * OSRHS) + 2) / fCLK_ADC
+     * ...which results in a maximum sampling rate of 833 ksps with the
+     * 2-clock input multiplexer switching time is included.
+     */
+    all_configs->configs[i].adcClkPrescale = IADC_calcAdcClkPrescale(IADC0,
+                                                                    this->scan_adc_clk_freq_target,
+                                                                    0,
+                                                                    iadcCfgModeNormal,
+                                                                    init->srcClkPrescale);
+  }
+
+  // Let the hardware oversample and average the single conversions according to the selected read resolution
+  this->configure_oversampling(&all_configs->configs[this->single_config_id], init_single, init->srcClkPrescale);
+  all_configs->configs[this->single_config_id].analogGain = analog_gain_map[this->current_adc_gain].setting;
+
+  // Precalculate the millivolt conversion factors, so converting a result only takes a multiplication and a shift
+  // The single-ended results span from 0 to the reference, the differential ones from minus to plus reference
+  uint32_t full_scale = (1u << this->single_conversion_resolution_bits) - 1u;
+  uint64_t scaled_vref = ((uint64_t)sl_adc_vref * analog_gain_map[this->current_adc_gain].denominator) << this->millivolt_scale_shift;
+  this->single_ended_millivolt_scale = (uint32_t)(scaled_vref / ((uint64_t)full_scale * analog_gain_map[this->current_adc_gain].numerator));
+  this->differential_millivolt_scale = (uint32_t)(scaled_vref / ((uint64_t)(full_scale >> 1) * analog_gain_map[this->current_adc_gain].numerator));
+
+  return SL_STATUS_OK;
+}
+
+sl_status_t AdcClass::init_adc()
+{
+  // Create ADC init structs with default values
+  IADC_Init_t init = IADC_INIT_DEFAULT;
+  IADC_AllConfigs_t all_configs = IADC_ALLCONFIGS_DEFAULT;
+  IADC_InitSingle_t init_single = IADC_INITSINGLE_DEFAULT;
+  IADC_SingleInput_t input = IADC_SINGLEINPUT_DEFAULT;
+  IADC_InitScan_t init_scan = IADC_INITSCAN_DEFAULT;
+
+  // Scan table structure
+  IADC_ScanTable_t scanTable = IADC_SCANTABLE_DEFAULT;
+
+  // Enable IADC0, GPIO and PRS clock branches
+  CMU_ClockEnable(cmuClock_IADC0, true);
+  CMU_ClockEnable(cmuClock_GPIO, true);
+  CMU_ClockEnable(cmuClock_PRS, true);
+
+  sl_status_t status = this->prepare_configs(&init, &all_configs, &init_single);
+  if (status != SL_STATUS_OK) {
+    return status;
   }
-  all_configs.configs[0].reference = sl_adc_reference;
-  all_configs.configs[0].vRef = sl_adc_vref;
 
   // Reset the ADC
   IADC_reset(IADC0);
@@ -99,141 +235,250 @@ void AdcClass::init_single(PinName pin, uint8_t reference)
     IADC_init(IADC0, &init, &all_configs);
   }
 
-  // Assign the input pin
-  uint32_t pin_index = pin - PIN_NAME_MIN;
-  input.posInput = GPIO_to_ADC_pin_map[pin_index];
-
-  // Initialize the ADC
+  // Set up the single queue - the input is left grounded until the first analogRead()
+  input.configId = this->single_config_id;
+  if (this->initialized_single) {
+    uint32_t pin_index = this->current_adc_pin - PIN_NAME_MIN;
+    input.posInput = GPIO_to_ADC_pin_map[pin_index];
+    if (this->current_adc_negative_pin != PIN_NAME_NC) {
+      input.negInput = IADC_portPinToNegInput(getSilabsPortFromArduinoPin(this->current_adc_negative_pin),
+                                              (uint8_t)getSilabsPinFromArduinoPin(this->current_adc_negative_pin));
+    }
+  }
   IADC_initSingle(IADC0, &init_single, &input);
-  IADC_enableInt(IADC0, IADC_IEN_SINGLEDONE);
 
-  // Allocate the analog bus for ADC0 inputs
-  // Port C and D are handled together
-  // Even and odd pins on the same port have a different register value
-  bool pin_is_even = (pin % 2 == 0);
-  if (pin >= PD0 || pin >= PC0) {
-    if (pin_is_even) {
-      GPIO->CDBUSALLOC |= GPIO_CDBUSALLOC_CDEVEN0_ADC0;
+  if (this->num_scan_pins > 0u) {
+    if (this->scan_prs_channel >= 0) {
+      // Convert the scan table once on every rising edge of the PRS channel
+      init_scan.triggerSelect = iadcTriggerSelPrs0PosEdge;
+      init_scan.triggerAction = iadcTriggerActionOnce;
+    } else if (this->scan_sample_rate_hz > 0u) {
+      // Convert the scan table once on every timer event
+      init_scan.triggerSelect = iadcTriggerSelTimer;
+      init_scan.triggerAction = iadcTriggerActionOnce;
     } else {
-      GPIO->CDBUSALLOC |= GPIO_CDBUSALLOC_CDODD0_ADC0;
+      // Trigger continuously once scan is started
+      init_scan.triggerAction = iadcTriggerActionContinuous;
     }
-  } else if (pin >= PB0) {
-    if (pin_is_even) {
-      GPIO->BBUSALLOC |= GPIO_BBUSALLOC_BEVEN0_ADC0;
-    } else {
-      GPIO->BBUSALLOC |= GPIO_BBUSALLOC_BODD0_ADC0;
+    // Set the SCANFIFODVL flag when scan FIFO holds 2 entries
+    // The interrupt associated with the SCANFIFODVL flag in the IADC_IF register is not used
+    init_scan.dataValidLevel = iadcFifoCfgDvl1;
+    // Enable DMA wake-up to save the results when the specified FIFO level is hit
+    // The window comparator only looks at the results and the triggered scan reads them in the interrupt
+    init_scan.fifoDmaWakeup = !this->window_comparator_enabled && (this->scan_prs_channel < 0);
+
+    // Add all the requested pins to the scan table
+    for (uint8_t i = 0u; i < this->num_scan_pins; i++) {
+      // Set up the ADC pin as an input
+      pinMode(this->scan_pins[i], INPUT);
+      uint32_t pin_index = this->scan_pins[i] - PIN_NAME_MIN;
+      scanTable.entries[i].configId = this->scan_config_id;
+      scanTable.entries[i].posInput = GPIO_to_ADC_pin_map[pin_index];
+      scanTable.entries[i].includeInScan = true;
+      scanTable.entries[i].compare = this->window_comparator_enabled;
+      // Allocate the analog bus for the ADC input
+      this->allocate_analog_bus(this->scan_pins[i]);
     }
-  } else {
-    if (pin_is_even) {
-      GPIO->ABUSALLOC |= GPIO_ABUSALLOC_AEVEN0_ADC0;
-    } else {
-      GPIO->ABUSALLOC |= GPIO_ABUSALLOC_AODD0_ADC0;
+
+    // Initialize scan
+    IADC_initScan(IADC0, &init_scan, &scanTable);
+
+    if (this->window_comparator_enabled) {
+      // Wake up the CPU only when a result matches the window condition
+      IADC_clearInt(IADC0, IADC_IF_SCANCMP);
+      IADC_enableInt(IADC0, IADC_IEN_SCANCMP);
+      NVIC_ClearPendingIRQ(IADC_IRQn);
+      NVIC_EnableIRQ(IADC_IRQn);
+    } else if (this->scan_prs_channel >= 0) {
+      // Let the trigger start the conversions and process every result as soon as it's ready
+      PRS->CONSUMER_IADC0_SCANTRIGGER = ((uint32_t)this->scan_prs_channel << _PRS_CONSUMER_IADC0_SCANTRIGGER_PRSSEL_SHIFT)
+                                        & _PRS_CONSUMER_IADC0_SCANTRIGGER_PRSSEL_MASK;
+      IADC_clearInt(IADC0, IADC_IF_SCANFIFODVL | IADC_IF_SCANFIFOOF);
+      IADC_enableInt(IADC0, IADC_IEN_SCANFIFODVL | IADC_IEN_SCANFIFOOF);
+      NVIC_SetPriority(IADC_IRQn, this->triggered_scan_irq_priority);
+      NVIC_ClearPendingIRQ(IADC_IRQn);
+      NVIC_EnableIRQ(IADC_IRQn);
     }
   }
 
-  this->initialized_scan = false;
-  this->initialized_single = true;
+  this->initialized_adc = true;
+  return SL_STATUS_OK;
 }
 
-void AdcClass::init_scan(PinName pin, uint8_t reference)
+void AdcClass::reinit()
 {
-  // Set up the ADC pin as an input
-  pinMode(pin, INPUT);
+  if (!this->initialized_adc) {
+    return;
+  }
+  this->init_adc();
+  // Restart the scan - a running DMA transfer continues with the new results
+  if (this->initialized_scan) {
+    this->start_scan_conversions();
+  }
+}
+
+void AdcClass::update_single_config()
+{
+  if (!this->initialized_adc) {
+    return;
+  }
 
-  // Create ADC init structs with default values
   IADC_Init_t init = IADC_INIT_DEFAULT;
   IADC_AllConfigs_t all_configs = IADC_ALLCONFIGS_DEFAULT;
-  IADC_InitScan_t init_scan = IADC_INITSCAN_DEFAULT;
+  IADC_InitSingle_t init_single = IADC_INITSINGLE_DEFAULT;
+  IADC_SingleInput_t input = IADC_SINGLEINPUT_DEFAULT;
 
-  // Scan table structure
-  IADC_ScanTable_t scanTable = IADC_SCANTABLE_DEFAULT;
+  if (this->prepare_configs(&init, &all_configs, &init_single) != SL_STATUS_OK) {
+    return;
+  }
 
-  // Enable IADC0, GPIO and PRS clock branches
-  CMU_ClockEnable(cmuClock_IADC0, true);
-  CMU_ClockEnable(cmuClock_GPIO, true);
-  CMU_ClockEnable(cmuClock_PRS, true);
+  // Rewrite the configurations without resetting the ADC - the scan table, the FIFO and interrupt
+  // setup and the comparator thresholds are kept, the scan configuration is written with the same values
+  // IADC_init() only disables the ADC while the registers are written, so an active scan pauses for a moment
+  IADC_init(IADC0, &init, &all_configs);
 
-  // Shutdown between conversions to reduce current
-  init.warmup = iadcWarmupNormal;
+  // The single FIFO alignment follows the read resolution
+  input.configId = this->single_config_id;
+  if (this->initialized_single) {
+    uint32_t pin_index = this->current_adc_pin - PIN_NAME_MIN;
+    input.posInput = GPIO_to_ADC_pin_map[pin_index];
+    if (this->current_adc_negative_pin != PIN_NAME_NC) {
+      input.negInput = IADC_portPinToNegInput(getSilabsPortFromArduinoPin(this->current_adc_negative_pin),
+                                              (uint8_t)getSilabsPinFromArduinoPin(this->current_adc_negative_pin));
+    }
+  }
+  IADC_initSingle(IADC0, &init_single, &input);
 
-  // Set the HFSCLK prescale value here
-  init.srcClkPrescale = IADC_calcSrcClkPrescale(IADC0, 20000000, 0);
+  // Disabling the ADC stops the scan conversions - a running DMA transfer continues with the new results
+  if (this->initialized_scan) {
+    this->start_scan_conversions();
+  }
+}
 
-  IADC_CfgReference_t sl_adc_reference;
-  uint32_t sl_adc_vref;
+void AdcClass::configure_oversampling(IADC_Config_t *config, IADC_InitSingle_t *init_single, uint8_t src_clk_prescale)
+{
+  uint8_t resolution = this->current_read_resolution;
+
+  if (resolution <= this->native_read_resolution_bits) {
+    // The default 2x oversampling provides the native resolution
+    config->osrHighSpeed = iadcCfgOsrHighSpeed2x;
+    init_single->alignment = iadcAlignRight12;
+    this->single_conversion_resolution_bits = this->native_read_resolution_bits;
+  } else if (resolution <= this->oversampled_read_resolution_bits) {
+    // Every doubling of the oversampling ratio adds one bit of resolution
+    static const IADC_CfgOsrHighSpeed_t osr_high_speed[] = {
+      iadcCfgOsrHighSpeed4x,
+      iadcCfgOsrHighSpeed8x,
+      iadcCfgOsrHighSpeed16x,
+      iadcCfgOsrHighSpeed32x
+    };
+    config->osrHighSpeed = osr_high_speed[resolution - this->native_read_resolution_bits - 1u];
+    init_single->alignment = iadcAlignRight16;
+    this->single_conversion_resolution_bits = this->oversampled_read_resolution_bits;
+  } else {
+#if defined(_IADC_CFG_ADCMODE_HIGHACCURACY)
+    // Use the high accuracy mode above 16 bits
+    static const IADC_CfgOsrHighAccuracy_t osr_high_accuracy[] = {
+      iadcCfgOsrHighAccuracy32x,
+      iadcCfgOsrHighAccuracy64x,
+      iadcCfgOsrHighAccuracy128x,
+      iadcCfgOsrHighAccuracy256x
+    };
+    config->adcMode = iadcCfgModeHighAccuracy;
+    config->osrHighAccuracy = osr_high_accuracy[resolution - this->oversampled_read_resolution_bits - 1u];
+    // The high accuracy mode needs a slower ADC clock
+    config->adcClkPrescale = IADC_calcAdcClkPrescale(IADC0,
+                                                     this->high_accuracy_adc_clk_freq_target,
+                                                     0,
+                                                     iadcCfgModeHighAccuracy,
+                                                     src_clk_prescale);
+    init_single->alignment = iadcAlignRight20;
+    this->single_conversion_resolution_bits = this->max_read_resolution_bits;
+#endif // defined(_IADC_CFG_ADCMODE_HIGHACCURACY)
+  }
 
-  // Set the voltage reference
-  switch (reference) {
-    case AR_INTERNAL1V2:
-      sl_adc_reference = iadcCfgReferenceInt1V2;
-      sl_adc_vref = 1200;
+#if defined(_IADC_CFG_DIGAVG_MASK)
+  // Average the consecutive conversions in hardware
+  switch (this->current_read_averaging) {
+    case 16u:
+      config->digAvg = iadcDigitalAverage16;
       break;
-
-    case AR_EXTERNAL_1V25:
-      sl_adc_reference = iadcCfgReferenceExt1V25;
-      sl_adc_vref = 1250;
+    case 8u:
+      config->digAvg = iadcDigitalAverage8;
       break;
-
-    case AR_VDD:
-      sl_adc_reference = iadcCfgReferenceVddx;
-      sl_adc_vref = 3300;
+    case 4u:
+      config->digAvg = iadcDigitalAverage4;
       break;
-
-    case AR_08VDD:
-      sl_adc_reference = iadcCfgReferenceVddX0P8Buf;
-      sl_adc_vref = 2640;
+    case 2u:
+      config->digAvg = iadcDigitalAverage2;
       break;
-
     default:
-      return;
+      config->digAvg = iadcDigitalAverage1;
+      break;
+  }
+#endif // defined(_IADC_CFG_DIGAVG_MASK)
+}
+
+void AdcClass::select_single_input(PinName positive_pin, PinName negative_pin)
+{
+  // Set up the ADC pin as an input
+  pinMode(positive_pin, INPUT);
+  // Allocate the analog bus for the ADC input
+  this->allocate_analog_bus(positive_pin);
+
+  IADC_SingleInput_t input = IADC_SINGLEINPUT_DEFAULT;
+  input.configId = this->single_config_id;
+  uint32_t pin_index = positive_pin - PIN_NAME_MIN;
+  input.posInput = GPIO_to_ADC_pin_map[pin_index];
+
+  if (negative_pin != PIN_NAME_NC) {
+    // The negative input is on the analog bus of the opposite polarity
+    pinMode(negative_pin, INPUT);
+    this->allocate_analog_bus(negative_pin);
+    input.negInput = IADC_portPinToNegInput(getSilabsPortFromArduinoPin(negative_pin),
+                                            (uint8_t)getSilabsPinFromArduinoPin(negative_pin));
   }
+  IADC_updateSingleInput(IADC0, &input);
+}
 
-  // Set the voltage reference
-  all_configs.configs[0].reference = sl_adc_reference;
-  all_configs.configs[0].vRef = sl_adc_vref;
-  all_configs.configs[0].osrHighSpeed = iadcCfgOsrHighSpeed2x;
-  all_configs.configs[0].analogGain = iadcCfgAnalogGain1x;
+uint32_t AdcClass::measure_supply_millivolts()
+{
+  IADC_Init_t init = IADC_INIT_DEFAULT;
+  IADC_AllConfigs_t all_configs = IADC_ALLCONFIGS_DEFAULT;
+  IADC_InitSingle_t init_single = IADC_INITSINGLE_DEFAULT;
+  IADC_SingleInput_t input = IADC_SINGLEINPUT_DEFAULT;
 
-  /*
-   * CLK_SRC_ADC must be prescaled by some value greater than 1 to
-   * derive the intended CLK_ADC frequency.
-   * Based on the default 2x oversampling rate (OSRHS)...
-   * conversion time = ((4 * OSRHS) + 2) / fCLK_ADC
-   * ...which results in a maximum sampling rate of 833 ksps with the
-   * 2-clock input multiplexer switching time is included.
-   */
+  // Convert the supply with the internal bandgap reference - IADC_init() applies the factory calibration
+  init.srcClkPrescale = IADC_calcSrcClkPrescale(IADC0, this->scan_src_clk_freq_target, 0);
+  all_configs.configs[0].reference = iadcCfgReferenceInt1V2;
+  all_configs.configs[0].vRef = this->internal_reference_millivolts;
   all_configs.configs[0].adcClkPrescale = IADC_calcAdcClkPrescale(IADC0,
-                                                                  10000000,
+                                                                  this->scan_adc_clk_freq_target,
                                                                   0,
                                                                   iadcCfgModeNormal,
                                                                   init.srcClkPrescale);
-
-  // Reset the ADC
   IADC_reset(IADC0);
+  IADC_init(IADC0, &init, &all_configs);
+  input.posInput = iadcPosInputAvdd;
+  IADC_initSingle(IADC0, &init_single, &input);
 
-  // Only configure the ADC if it is not already running
-  if (IADC0->CTRL == _IADC_CTRL_RESETVALUE) {
-    IADC_init(IADC0, &init, &all_configs);
+  IADC_clearInt(IADC0, IADC_IF_SINGLEDONE);
+  IADC_command(IADC0, iadcCmdStartSingle);
+  uint32_t conversion_start = micros();
+  while (!(IADC_getInt(IADC0) & IADC_IF_SINGLEDONE) && (micros() - conversion_start) < this->supply_conversion_timeout_us) ;
+  if (!(IADC_getInt(IADC0) & IADC_IF_SINGLEDONE)) {
+    // Fall back to the nominal supply voltage if the conversion never finishes
+    return this->nominal_supply_millivolts;
   }
+  uint32_t result = IADC_readSingleData(IADC0);
 
-  // Assign the input pin
-  uint32_t pin_index = pin - PIN_NAME_MIN;
-
-  // Trigger continuously once scan is started
-  init_scan.triggerAction = iadcTriggerActionContinuous;
-  // Set the SCANFIFODVL flag when scan FIFO holds 2 entries
-  // The interrupt associated with the SCANFIFODVL flag in the IADC_IF register is not used
-  init_scan.dataValidLevel = iadcFifoCfgDvl1;
-  // Enable DMA wake-up to save the results when the specified FIFO level is hit
-  init_scan.fifoDmaWakeup = true;
-
-  scanTable.entries[0].posInput = GPIO_to_ADC_pin_map[pin_index];
-  scanTable.entries[0].includeInScan = true;
-
-  // Initialize scan
-  IADC_initScan(IADC0, &init_scan, &scanTable);
-  IADC_enableInt(IADC0, IADC_IEN_SCANTABLEDONE);
+  // The supply input is internally divided by four
+  const uint32_t full_scale = (1u << this->native_read_resolution_bits) - 1u;
+  return ((result * this->internal_reference_millivolts * 4u) + (full_scale / 2u)) / full_scale;
+}
 
+void AdcClass::allocate_analog_bus(PinName pin)
+{
   // Allocate the analog bus for ADC0 inputs
   // Port C and D are handled together
   // Even and odd pins on the same port have a different register value
@@ -257,12 +502,9 @@ void AdcClass::init_scan(PinName pin, uint8_t reference)
       GPIO->ABUSALLOC |= GPIO_ABUSALLOC_AODD0_ADC0;
     }
   }
-
-  this->initialized_single = false;
-  this->initialized_scan = true;
 }
 
-sl_status_t AdcClass::init_dma(uint32_t *buffer, uint32_t size)
+sl_status_t AdcClass::init_dma(void *buffer, uint32_t size, bool half_word)
 {
   sl_status_t status;
   if (!this->initialized_scan) {
@@ -287,24 +529,38 @@ sl_status_t AdcClass::init_dma(uint32_t *buffer, uint32_t size)
    * (the last argument is the relative jump in terms of the number of
    * descriptors), transfers will run continuously.
    */
+  #pragma GCC diagnostic push
   #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
   this->ldma_descriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&(IADC0->SCANFIFODATA), buffer, size, 0);
+  #pragma GCC diagnostic pop
+  if (half_word) {
+    // Only read the lower half of the FIFO entries which holds the 12-bit result
+    this->ldma_descriptor.xfer.size = ldmaCtrlSizeHalf;
+  }
 
   DMADRV_LdmaStartTransfer((int)this->dma_channel, &transferCfg, &this->ldma_descriptor, dma_transfer_finished_cb, NULL);
   return SL_STATUS_OK;
 }
 
-uint16_t AdcClass::get_sample(PinName pin)
+int32_t AdcClass::convert_single(PinName positive_pin, PinName negative_pin, uint8_t gain)
 {
-  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+  // The gain is part of the single queue configuration - an active scan keeps running
+  if (gain != this->current_adc_gain) {
+    this->current_adc_gain = gain;
+    this->update_single_config();
+  }
 
-  if (this->initialized_scan) {
-    this->scan_stop();
+  // The single queue runs alongside an active scan or window comparator - neither of them is stopped
+  if (!this->initialized_adc && this->init_adc() != SL_STATUS_OK) {
+    return 0;
   }
 
-  if (!this->initialized_single || (pin != this->current_adc_pin)) {
-    this->current_adc_pin = pin;
-    this->init_single(this->current_adc_pin, this->current_adc_reference);
+  if (!this->initialized_single || positive_pin != this->current_adc_pin || negative_pin != this->current_adc_negative_pin) {
+    // Only switch the input multiplexer, the ADC stays configured
+    this->current_adc_pin = positive_pin;
+    this->current_adc_negative_pin = negative_pin;
+    this->select_single_input(this->current_adc_pin, this->current_adc_negative_pin);
+    this->initialized_single = true;
   }
   // Clear single done interrupt
   IADC_clearInt(IADC0, IADC_IF_SINGLEDONE);
@@ -314,16 +570,74 @@ uint16_t AdcClass::get_sample(PinName pin)
   while (!(IADC_getInt(IADC0) & IADC_IF_SINGLEDONE)) {
     yield();
   }
-  uint16_t result = IADC_readSingleData(IADC0);
+  uint32_t result = IADC_readSingleData(IADC0);
+
+  if (negative_pin == PIN_NAME_NC) {
+    return (int32_t)result;
+  }
+  // Differential results are in two's complement - extend the sign from the conversion resolution
+  const uint8_t sign_shift = 32u - this->single_conversion_resolution_bits;
+  return (int32_t)(result << sign_shift) >> sign_shift;
+}
+
+bool AdcClass::is_valid_differential_input(PinName positive_pin, PinName negative_pin, uint8_t gain)
+{
+  if (positive_pin == PIN_NAME_NC || negative_pin == PIN_NAME_NC || gain >= AG_MAX) {
+    return false;
+  }
+  // The inputs must be on the even and the odd analog bus
+  return (positive_pin % 2) != (negative_pin % 2);
+}
 
+uint32_t AdcClass::get_sample(PinName pin)
+{
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+  uint32_t result = (uint32_t)this->convert_single(pin, PIN_NAME_NC, AG_1X);
+  // Apply the configured read resolution
+  result = result >> (this->single_conversion_resolution_bits - this->current_read_resolution);
   xSemaphoreGive(this->adc_mutex);
 
+  return result;
+}
+
+int32_t AdcClass::get_differential_sample(PinName positive_pin, PinName negative_pin, uint8_t gain)
+{
+  if (!this->is_valid_differential_input(positive_pin, negative_pin, gain)) {
+    return 0;
+  }
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+  int32_t result = this->convert_single(positive_pin, negative_pin, gain);
   // Apply the configured read resolution
-  result = result >> (this->max_read_resolution_bits - this->current_read_resolution);
+  result = result >> (this->single_conversion_resolution_bits - this->current_read_resolution);
+  xSemaphoreGive(this->adc_mutex);
 
   return result;
 }
 
+int32_t AdcClass::get_millivolts(PinName pin)
+{
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+  int32_t result = this->convert_single(pin, PIN_NAME_NC, AG_1X);
+  // Fixed-point conversion with rounding - no floating point or division needed
+  int64_t millivolts = ((int64_t)result * this->single_ended_millivolt_scale) + (1 << (this->millivolt_scale_shift - 1u));
+  xSemaphoreGive(this->adc_mutex);
+
+  return (int32_t)(millivolts >> this->millivolt_scale_shift);
+}
+
+int32_t AdcClass::get_differential_millivolts(PinName positive_pin, PinName negative_pin, uint8_t gain)
+{
+  if (!this->is_valid_differential_input(positive_pin, negative_pin, gain)) {
+    return 0;
+  }
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+  int32_t result = this->convert_single(positive_pin, negative_pin, gain);
+  int64_t millivolts = ((int64_t)result * this->differential_millivolt_scale) + (1 << (this->millivolt_scale_shift - 1u));
+  xSemaphoreGive(this->adc_mutex);
+
+  return (int32_t)(millivolts >> this->millivolt_scale_shift);
+}
+
 void AdcClass::set_reference(uint8_t reference)
 {
   if (reference >= AR_MAX || reference == this->current_adc_reference) {
@@ -331,10 +645,17 @@ void AdcClass::set_reference(uint8_t reference)
   }
   xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
   this->current_adc_reference = reference;
-  if (this->initialized_single) {
-    this->init_single(this->current_adc_pin, this->current_adc_reference);
-  } else if (this->initialized_scan) {
-    this->init_scan(this->current_adc_pin, this->current_adc_reference);
+  this->reinit();
+  xSemaphoreGive(this->adc_mutex);
+}
+
+void AdcClass::update_supply_voltage()
+{
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+  // Clearing the cached value makes the next ADC init measure the supply
+  this->supply_millivolts = 0u;
+  if (this->current_adc_reference == AR_VDD || this->current_adc_reference == AR_08VDD) {
+    this->reinit();
   }
   xSemaphoreGive(this->adc_mutex);
 }
@@ -342,67 +663,371 @@ void AdcClass::set_reference(uint8_t reference)
 void AdcClass::set_read_resolution(uint8_t resolution)
 {
   if (resolution > this->max_read_resolution_bits) {
-    this->current_read_resolution = this->max_read_resolution_bits;
+    resolution = this->max_read_resolution_bits;
+  }
+  if (resolution == this->current_read_resolution) {
     return;
   }
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
   this->current_read_resolution = resolution;
+  // Reconfigure the oversampling of the single queue if the ADC is already in use
+  this->update_single_config();
+  xSemaphoreGive(this->adc_mutex);
+}
+
+void AdcClass::set_read_averaging(uint8_t samples)
+{
+  // Round down to the nearest supported number of samples
+  uint8_t averaging = 1u;
+  while (averaging < this->max_read_averaging && (averaging * 2u) <= samples) {
+    averaging *= 2u;
+  }
+  if (averaging == this->current_read_averaging) {
+    return;
+  }
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+  this->current_read_averaging = averaging;
+  // Reconfigure the averaging of the single queue if the ADC is already in use
+  this->update_single_config();
+  xSemaphoreGive(this->adc_mutex);
 }
 
 sl_status_t AdcClass::scan_start(PinName pin, uint32_t *buffer, uint32_t size, void (*user_onsampling_finished_callback)())
 {
+  return this->start_scan(&pin, 1u, buffer, size, false, 0u, user_onsampling_finished_callback);
+}
+
+sl_status_t AdcClass::scan_start(PinName pin, uint16_t *buffer, uint32_t size, void (*user_onsampling_finished_callback)())
+{
+  return this->start_scan(&pin, 1u, buffer, size, true, 0u, user_onsampling_finished_callback);
+}
+
+sl_status_t AdcClass::scan_start(const PinName *pins, uint8_t num_pins, uint32_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)())
+{
+  return this->start_scan(pins, num_pins, buffer, size, false, sample_rate_hz, user_onsampling_finished_callback);
+}
+
+sl_status_t AdcClass::scan_start(const PinName *pins, uint8_t num_pins, uint16_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)())
+{
+  return this->start_scan(pins, num_pins, buffer, size, true, sample_rate_hz, user_onsampling_finished_callback);
+}
+
+sl_status_t AdcClass::start_scan(const PinName *pins, uint8_t num_pins, void *buffer, uint32_t size, bool half_word, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)())
+{
+  if (!pins || num_pins == 0u || num_pins > this->max_scan_pins || !buffer || size == 0u) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
   sl_status_t status = SL_STATUS_FAIL;
   xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
 
-  if ((!this->initialized_scan && !this->initialized_single) || (pin != this->current_adc_pin)) {
-    // Initialize in scan mode
-    this->current_adc_pin = pin;
-    this->user_onsampling_finished_callback = user_onsampling_finished_callback;
-    this->init_scan(this->current_adc_pin, this->current_adc_reference);
-    status = this->init_dma(buffer, size);
-  } else if (this->initialized_scan && this->paused_transfer) {
+  // Check whether the requested scan is the same as the current one
+  bool same_scan = this->initialized_scan
+                   && !this->window_comparator_enabled
+                   && (buffer == this->scan_buffer)
+                   && (half_word == this->scan_buffer_half_words)
+                   && (num_pins == this->num_scan_pins)
+                   && (sample_rate_hz == this->scan_sample_rate_hz)
+                   && (memcmp(pins, this->scan_pins, num_pins * sizeof(PinName)) == 0);
+
+  if (same_scan && this->paused_transfer) {
     // Resume DMA transfer if paused
     status = DMADRV_ResumeTransfer(this->dma_channel);
     this->paused_transfer = false;
-  } else if (this->initialized_single) {
-    // Initialize in scan mode if it was initialized in single mode
-    this->deinit();
-    this->current_adc_pin = pin;
-    this->user_onsampling_finished_callback = user_onsampling_finished_callback;
-    this->init_scan(this->current_adc_pin, this->current_adc_reference);
-    status = this->init_dma(buffer, size);
+  } else if (same_scan) {
+    // The requested scan is already running
+    xSemaphoreGive(this->adc_mutex);
+    return status;
   } else {
+    // Release the resources of the previous scan - the single queue is kept
+    this->release_scan();
+    // Initialize in scan mode
+    memcpy(this->scan_pins, pins, num_pins * sizeof(PinName));
+    this->num_scan_pins = num_pins;
+    this->scan_sample_rate_hz = sample_rate_hz;
+    this->scan_buffer = buffer;
+    this->scan_buffer_half_words = half_word;
+    this->user_onsampling_finished_callback = user_onsampling_finished_callback;
+    status = this->init_adc();
+    if (status == SL_STATUS_OK) {
+      this->initialized_scan = true;
+      status = this->init_dma(buffer, size, half_word);
+    }
+    if (status != SL_STATUS_OK) {
+      this->release_scan();
+    }
+  }
+
+  if (status != SL_STATUS_OK) {
     xSemaphoreGive(this->adc_mutex);
     return status;
   }
 
   // Start the conversion and wait for results
-  IADC_command(IADC0, iadcCmdStartScan);
+  this->start_scan_conversions();
 
   xSemaphoreGive(this->adc_mutex);
   return status;
 }
 
+sl_status_t AdcClass::window_comparator_start(PinName pin, uint16_t low_threshold, uint16_t high_threshold, uint32_t sample_rate_hz, void (*user_window_comparator_callback)(bool))
+{
+  uint16_t max_threshold = (1u << this->native_read_resolution_bits) - 1u;
+  if (pin == PIN_NAME_NC || !user_window_comparator_callback || sample_rate_hz == 0u
+      || low_threshold > high_threshold || high_threshold > max_threshold
+      || (low_threshold == 0u && high_threshold == max_threshold)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+
+  // Release the resources of the previous scan - the single queue is kept
+  this->release_scan();
+
+  this->scan_pins[0] = pin;
+  this->num_scan_pins = 1u;
+  this->scan_sample_rate_hz = sample_rate_hz;
+  this->window_low_threshold = low_threshold;
+  this->window_high_threshold = high_threshold;
+  this->window_comparator_armed_inside = true;
+  this->user_window_comparator_callback = user_window_comparator_callback;
+  this->window_comparator_enabled = true;
+
+  // Clock the ADC from the FSRCO which keeps running in EM2 - the original clock is restored on stop
+  this->saved_iadc_clock = CMU_ClockSelectGet(cmuClock_IADCCLK);
+  CMU_ClockSelectSet(cmuClock_IADCCLK, cmuSelect_FSRCO);
+
+  sl_status_t status = this->init_adc();
+  if (status != SL_STATUS_OK) {
+    this->release_scan();
+    xSemaphoreGive(this->adc_mutex);
+    return status;
+  }
+
+  this->initialized_scan = true;
+  this->start_scan_conversions();
+
+  xSemaphoreGive(this->adc_mutex);
+  return SL_STATUS_OK;
+}
+
+sl_status_t AdcClass::scan_start_triggered(PinName pin, unsigned int prs_channel, void (*user_onsample_callback)(uint32_t sample))
+{
+  if (pin == PIN_NAME_NC || prs_channel >= PRS_ASYNC_CH_NUM || !user_onsample_callback) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+
+  // Release the resources of the previous scan - the single queue is kept
+  this->release_scan();
+
+  this->scan_pins[0] = pin;
+  this->num_scan_pins = 1u;
+  // The trigger paces the conversions instead of the local timer
+  this->scan_sample_rate_hz = 0u;
+  this->scan_prs_channel = (int)prs_channel;
+  this->scan_overrun_count = 0u;
+  this->user_onsample_callback = user_onsample_callback;
+  this->default_irq_priority = NVIC_GetPriority(IADC_IRQn);
+
+  sl_status_t status = this->init_adc();
+  if (status != SL_STATUS_OK) {
+    this->release_scan();
+    xSemaphoreGive(this->adc_mutex);
+    return status;
+  }
+
+  // Arm the scan queue - the conversions start with the first trigger
+  this->initialized_scan = true;
+  this->start_scan_conversions();
+
+  xSemaphoreGive(this->adc_mutex);
+  return SL_STATUS_OK;
+}
+
+uint32_t AdcClass::get_scan_overrun_count()
+{
+  return this->scan_overrun_count;
+}
+
+void AdcClass::window_comparator_stop()
+{
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+  if (this->window_comparator_enabled) {
+    this->release_scan();
+    // Recalculate the prescalers of the single queue for the restored ADC clock
+    this->update_single_config();
+  }
+  xSemaphoreGive(this->adc_mutex);
+}
+
+void AdcClass::start_scan_conversions()
+{
+  IADC_command(IADC0, iadcCmdStartScan);
+  // Start the local timer which paces the conversions
+  if (this->scan_timer_cycles > 0u) {
+    IADC_command(IADC0, iadcCmdEnableTimer);
+  }
+}
+
+uint32_t AdcClass::get_window_comparator_thresholds(bool detect_inside)
+{
+  // The thresholds are compared to the results in 16-bit left aligned format
+  const uint8_t shift = 16u - this->native_read_resolution_bits;
+  const uint32_t lsb_mask = (1u << shift) - 1u;
+  const uint16_t max_threshold = (1u << this->native_read_resolution_bits) - 1u;
+  uint32_t greater_than_equal;
+  uint32_t less_than_equal;
+
+  if (detect_inside) {
+    // A lower 'greater than' threshold than 'less than' matches results inside the window
+    greater_than_equal = (uint32_t)this->window_low_threshold << shift;
+    less_than_equal = ((uint32_t)this->window_high_threshold << shift) | lsb_mask;
+  } else if (this->window_low_threshold == 0u) {
+    // Nothing is below the window - match everything above it instead
+    greater_than_equal = ((uint32_t)this->window_high_threshold + 1u) << shift;
+    less_than_equal = UINT16_MAX;
+  } else if (this->window_high_threshold == max_threshold) {
+    // Nothing is above the window - match everything below it instead
+    greater_than_equal = 0u;
+    less_than_equal = (((uint32_t)this->window_low_threshold - 1u) << shift) | lsb_mask;
+  } else {
+    // A higher 'greater than' threshold than 'less than' matches results outside the window
+    greater_than_equal = ((uint32_t)this->window_high_threshold + 1u) << shift;
+    less_than_equal = (((uint32_t)this->window_low_threshold - 1u) << shift) | lsb_mask;
+  }
+
+  return (greater_than_equal << _IADC_CMPTHR_ADGT_SHIFT) | (less_than_equal << _IADC_CMPTHR_ADLT_SHIFT);
+}
+
+void AdcClass::handle_triggered_scan_irq()
+{
+  if (this->scan_prs_channel < 0) {
+    return;
+  }
+
+  uint32_t flags = IADC_getInt(IADC0);
+  IADC_clearInt(IADC0, flags & (IADC_IF_SCANFIFODVL | IADC_IF_SCANFIFOOF));
+  if (flags & IADC_IF_SCANFIFOOF) {
+    this->scan_overrun_count++;
+  }
+
+  // Every result is processed - more than one means the callback took longer than a trigger period
+  bool first_result = true;
+  while (IADC_getScanFifoCnt(IADC0) > 0u) {
+    uint32_t sample = IADC_pullScanFifoResult(IADC0).data;
+    if (!first_result) {
+      this->scan_overrun_count++;
+    }
+    first_result = false;
+    this->user_onsample_callback(sample);
+  }
+}
+
+void AdcClass::handle_window_comparator_irq()
+{
+  uint32_t flags = IADC_getInt(IADC0);
+  IADC_clearInt(IADC0, flags & (IADC_IF_SCANCMP | IADC_IF_SCANFIFOOF));
+
+  // Only the matching results are written to the FIFO - drop them so it never fills up
+  while (IADC_getScanFifoCnt(IADC0) > 0u) {
+    (void)IADC_pullScanFifoResult(IADC0);
+  }
+
+  if (!(flags & IADC_IF_SCANCMP) || !this->window_comparator_enabled) {
+    return;
+  }
+
+  // The signal made the transition the comparator was armed for
+  bool inside = this->window_comparator_armed_inside;
+  // Arm the comparator for the opposite transition
+  this->window_comparator_armed_inside = !inside;
+  IADC0->CMPTHR = this->get_window_comparator_thresholds(this->window_comparator_armed_inside);
+
+  if (this->user_window_comparator_callback) {
+    this->user_window_comparator_callback(inside);
+  }
+}
+
+float AdcClass::get_scan_sample_rate()
+{
+  if (!this->initialized_scan || this->scan_timer_cycles == 0u) {
+    return 0.0f;
+  }
+  return (float)this->scan_src_clk_freq / (float)this->scan_timer_cycles;
+}
+
 void AdcClass::scan_stop()
 {
-  // Pause sampling
-  DMADRV_PauseTransfer(this->dma_channel);
-  this->paused_transfer = true;
+  // Triggered scans have no DMA transfer to pause
+  if (this->scan_prs_channel >= 0) {
+    xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+    this->release_scan();
+    xSemaphoreGive(this->adc_mutex);
+    return;
+  }
+
+  xSemaphoreTake(this->adc_mutex, portMAX_DELAY);
+  // Only a running DMA scan owns the channel - the window comparator has its own stop function
+  if (this->initialized_scan && !this->window_comparator_enabled && this->dma_channel < EMDRV_DMADRV_DMA_CH_COUNT) {
+    // Pause sampling
+    DMADRV_PauseTransfer(this->dma_channel);
+    this->paused_transfer = true;
+  }
+  xSemaphoreGive(this->adc_mutex);
+}
+
+void AdcClass::release_scan()
+{
+  if (this->window_comparator_enabled) {
+    // Stop the window comparator interrupts
+    NVIC_DisableIRQ(IADC_IRQn);
+    IADC_disableInt(IADC0, IADC_IEN_SCANCMP);
+    // Give the ADC its original clock back
+    CMU_ClockSelectSet(cmuClock_IADCCLK, this->saved_iadc_clock);
+    this->window_comparator_enabled = false;
+    this->user_window_comparator_callback = nullptr;
+  } else if (this->scan_prs_channel >= 0) {
+    // Stop the triggered scan interrupts and give the interrupt its original priority back
+    NVIC_DisableIRQ(IADC_IRQn);
+    IADC_disableInt(IADC0, IADC_IEN_SCANFIFODVL | IADC_IEN_SCANFIFOOF);
+    NVIC_SetPriority(IADC_IRQn, this->default_irq_priority);
+    this->scan_prs_channel = -1;
+    this->user_onsample_callback = nullptr;
+  } else if (this->initialized_scan) {
+    // Stop sampling
+    DMADRV_StopTransfer(this->dma_channel);
+
+    // Free resources
+    DMADRV_FreeChannel(this->dma_channel);
+    this->dma_channel = EMDRV_DMADRV_DMA_CH_COUNT;
+  }
+
+  if (this->initialized_scan) {
+    // Stop the scan conversions, the single queue stays usable
+    IADC_command(IADC0, iadcCmdDisableTimer);
+    IADC_command(IADC0, iadcCmdStopScan);
+  }
+
+  this->initialized_scan = false;
+  this->paused_transfer = false;
+  this->num_scan_pins = 0u;
+  this->scan_timer_cycles = 0u;
+  this->scan_buffer = nullptr;
 }
 
 void AdcClass::deinit()
 {
-  // Stop sampling
-  DMADRV_StopTransfer(this->dma_channel);
-
-  // Free resources
-  DMADRV_FreeChannel(this->dma_channel);
+  this->release_scan();
 
   // Reset the ADC
   IADC_reset(IADC0);
 
-  this->initialized_scan = false;
+  this->initialized_adc = false;
   this->initialized_single = false;
   this->current_adc_pin = PIN_NAME_NC;
+  this->current_adc_negative_pin = PIN_NAME_NC;
 }
 
 void AdcClass::handle_dma_finished_callback()
@@ -414,6 +1039,12 @@ void AdcClass::handle_dma_finished_callback()
   this->user_onsampling_finished_callback();
 }
 
+void IADC_IRQHandler(void)
+{
+  ADC.handle_triggered_scan_irq();
+  ADC.handle_window_comparator_irq();
+}
+
 bool dma_transfer_finished_cb(unsigned int channel, unsigned int sequenceNo, void *userParam)
 {
   (void)channel;
@@ -31,6 +31,7 @@
 #define __ARDUINO_ADC_H
 
 #include <cmath>
+#include <cstring>
 #include <inttypes.h>
 #include "em_cmu.h"
 #include "em_iadc.h"
@@ -48,6 +49,15 @@ enum analog_references {
   AR_MAX              // Maximum value
 };
 
+enum analog_gains {
+  AG_0P5X = 0,        // 0.5x analog gain
+  AG_1X,              // 1x analog gain
+  AG_2X,              // 2x analog gain
+  AG_3X,              // 3x analog gain
+  AG_4X,              // 4x analog gain
+  AG_MAX              // Maximum value
+};
+
 namespace arduino {
 class AdcClass {
 public:
@@ -59,12 +69,49 @@ public:
 
   /***************************************************************************//**
    * Performs a single ADC measurement on the provided pin and returns the sample
+   * The measurement runs on the single queue, an active scan or window comparator keeps running
    *
    * @param[in] pin The pin number of the ADC input
    *
    * @return the measured ADC sample
    ******************************************************************************/
-  uint16_t get_sample(PinName pin);
+  uint32_t get_sample(PinName pin);
+
+  /***************************************************************************//**
+   * Performs a differential ADC measurement between the provided pins
+   *
+   * One of the pins has to be even and the other odd numbered within their ports.
+   *
+   * @param[in] positive_pin The pin number of the positive ADC input
+   * @param[in] negative_pin The pin number of the negative ADC input
+   * @param[in] gain The selected analog gain from 'analog_gains'
+   *
+   * @return the measured signed ADC sample, 0 if the inputs are invalid
+   ******************************************************************************/
+  int32_t get_differential_sample(PinName positive_pin, PinName negative_pin, uint8_t gain);
+
+  /***************************************************************************//**
+   * Performs a single ADC measurement on the provided pin and returns the voltage
+   *
+   * The result is calibrated with the factory trimmed ADC gain and offset, the VDD
+   * references are measured against the internal bandgap reference.
+   *
+   * @param[in] pin The pin number of the ADC input
+   *
+   * @return the measured voltage in millivolts
+   ******************************************************************************/
+  int32_t get_millivolts(PinName pin);
+
+  /***************************************************************************//**
+   * Performs a differential ADC measurement and returns the voltage between the pins
+   *
+   * @param[in] positive_pin The pin number of the positive ADC input
+   * @param[in] negative_pin The pin number of the negative ADC input
+   * @param[in] gain The selected analog gain from 'analog_gains'
+   *
+   * @return the measured voltage in millivolts, 0 if the inputs are invalid
+   ******************************************************************************/
+  int32_t get_differential_millivolts(PinName positive_pin, PinName negative_pin, uint8_t gain);
 
   /***************************************************************************//**
    * Sets the ADC voltage reference
@@ -73,13 +120,39 @@ public:
    ******************************************************************************/
   void set_reference(uint8_t reference);
 
+  /***************************************************************************//**
+   * Measures the supply voltage used by the VDD references again
+   *
+   * The supply is only measured when the ADC is initialized with a VDD reference
+   * and the result is cached - call this when the supply may have changed
+   * (e.g. a discharging battery). A running scan is restarted.
+   ******************************************************************************/
+  void update_supply_voltage();
+
   /***************************************************************************//**
    * Sets the ADC read resolution
    *
+   * Resolutions above the native 12 bits are achieved with hardware oversampling,
+   * 17 to 20 bits use the high accuracy mode where the device supports it.
+   * Higher resolutions result in longer conversion times.
+   * Only the single conversions are affected, scans keep the native resolution.
+   * An active scan or window comparator keeps running, it only pauses while the
+   * ADC is reconfigured.
+   *
    * @param[in] resolution The selected read resolution in bits
    ******************************************************************************/
   void set_read_resolution(uint8_t resolution);
 
+  /***************************************************************************//**
+   * Sets the number of conversions the hardware averages into one reading
+   *
+   * Only the single conversions are affected. An active scan or window comparator
+   * keeps running, it only pauses while the ADC is reconfigured.
+   *
+   * @param[in] samples The number of averaged conversions - rounded down to 1, 2, 4, 8 or 16
+   ******************************************************************************/
+  void set_read_averaging(uint8_t samples);
+
   /***************************************************************************//**
    * Starts ADC in scan (continuous) mode
    *
@@ -91,11 +164,120 @@ public:
    ******************************************************************************/
   sl_status_t scan_start(PinName pin, uint32_t *buffer, uint32_t size, void (*user_onsampling_finished_callback)());
 
+  /***************************************************************************//**
+   * Starts ADC in scan (continuous) mode storing the samples on 16 bits
+   *
+   * The samples are moved with half-word DMA transfers, which halves the buffer
+   * size compared to the 32-bit variant. The 12-bit results fit in the lower
+   * half of the FIFO entries.
+   *
+   * @param[in] pin The pin number of the ADC input
+   * @param[in] buffer The buffer where the sampled data is stored
+   * @param[in] size The number of samples in the buffer
+   * @param[in] user_onsampling_finished_callback Called when the buffer is full
+   *
+   * @return Status of the scan init process
+   ******************************************************************************/
+  sl_status_t scan_start(PinName pin, uint16_t *buffer, uint32_t size, void (*user_onsampling_finished_callback)());
+
+  /***************************************************************************//**
+   * Starts ADC in scan mode on one or more pins at a fixed sample rate
+   *
+   * The conversions are paced by the IADC's local timer, so the samples are
+   * taken at an exact interval. Each timer event converts every pin once and
+   * the results are stored interleaved in the buffer (pin0, pin1, ... pin0, ...).
+   * Passing zero as the sample rate makes the ADC convert continuously at the
+   * highest rate the hardware allows.
+   * The 16-bit timer runs from the ADC source clock divided by at most 4, so the
+   * lowest rate is about 149 Hz with a 39 MHz and 298 Hz with a 78 MHz ADC clock.
+   *
+   * @param[in] pins Array of the ADC input pins
+   * @param[in] num_pins Number of pins in the array (max 'max_scan_pins')
+   * @param[in] buffer The buffer where the sampled data is stored
+   * @param[in] size The size of the buffer - should be a multiple of 'num_pins'
+   * @param[in] sample_rate_hz The requested per pin sample rate in Hz
+   * @param[in] user_onsampling_finished_callback Called when the buffer is full
+   *
+   * @return Status of the scan init process - SL_STATUS_INVALID_RANGE if the sample
+   *         rate is below the timer's minimum or too high for the number of pins
+   ******************************************************************************/
+  sl_status_t scan_start(const PinName *pins, uint8_t num_pins, uint32_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)());
+  sl_status_t scan_start(const PinName *pins, uint8_t num_pins, uint16_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)());
+
+  /***************************************************************************//**
+   * Starts converting a pin on every rising edge of a PRS channel
+   *
+   * The conversions are triggered by an other peripheral (e.g. a timer) through the
+   * PRS, so they are taken in lockstep with it. Each result is passed to the callback
+   * right away from the ADC interrupt, which runs at 'triggered_scan_irq_priority'.
+   * This priority is above the RTOS kernel, so the callback must not call any RTOS
+   * APIs, and it has to return before the next trigger arrives.
+   *
+   * @param[in] pin The pin number of the ADC input
+   * @param[in] prs_channel The asynchronous PRS channel triggering the conversions
+   * @param[in] user_onsample_callback Called with every 12-bit result
+   *
+   * @return Status of the scan init process
+   ******************************************************************************/
+  sl_status_t scan_start_triggered(PinName pin, unsigned int prs_channel, void (*user_onsample_callback)(uint32_t sample));
+
+  /***************************************************************************//**
+   * Returns the number of triggered conversions which arrived before the callback
+   * finished processing the previous one
+   *
+   * @return the number of overruns since the triggered scan was started
+   ******************************************************************************/
+  uint32_t get_scan_overrun_count();
+
+  /***************************************************************************//**
+   * Returns the sample rate actually achieved by the running scan
+   *
+   * The timer can only divide the ADC clock by an integer, so the achieved
+   * rate can slightly differ from the requested one.
+   *
+   * @return the per pin sample rate in Hz, 0 if the scan is not timer paced
+   ******************************************************************************/
+  float get_scan_sample_rate();
+
   /***************************************************************************//**
    * Stops ADC scan
+   * DMA scans are paused and can be resumed, triggered scans are stopped entirely
    ******************************************************************************/
   void scan_stop();
 
+  /***************************************************************************//**
+   * Starts watching a pin with the ADC's window comparator
+   *
+   * The pin is converted periodically by the ADC's own timer without any CPU
+   * involvement, also while the device sleeps in EM2. The callback is only called
+   * when the signal enters or leaves the window between the two thresholds.
+   * The comparator starts by waiting for the signal to be inside the window,
+   * so the first callback comes right away if the signal is already there.
+   * The callback is called from interrupt context.
+   * Any DMA sampling is stopped, analogRead() keeps working alongside the comparator.
+   * The ADC is clocked from the FSRCO while the comparator runs, the previous ADC
+   * clock is restored when it's stopped.
+   * The rate is set by the 16-bit local timer running from the prescaled FSRCO,
+   * so the lowest supported rate is about 76 Hz.
+   *
+   * @param[in] pin The pin number of the ADC input
+   * @param[in] low_threshold The lower bound of the window in 12-bit ADC counts (0 - 4095)
+   * @param[in] high_threshold The upper bound of the window in 12-bit ADC counts (0 - 4095),
+   *            the window can't cover the whole range
+   * @param[in] sample_rate_hz The rate the pin is checked at in Hz
+   * @param[in] user_window_comparator_callback Called with 'true' when the signal enters
+   *            the window, and with 'false' when it leaves
+   *
+   * @return Status of the comparator init process - SL_STATUS_INVALID_RANGE if the
+   *         sample rate is too low or too high for the timer
+   ******************************************************************************/
+  sl_status_t window_comparator_start(PinName pin, uint16_t low_threshold, uint16_t high_threshold, uint32_t sample_rate_hz, void (*user_window_comparator_callback)(bool));
+
+  /***************************************************************************//**
+   * Stops the window comparator
+   ******************************************************************************/
+  void window_comparator_stop();
+
   /***************************************************************************//**
    * De-initialize the ADC
    ******************************************************************************/
@@ -106,52 +288,240 @@ public:
    ******************************************************************************/
   void handle_dma_finished_callback();
 
+  /***************************************************************************//**
+   * Interrupt handler for the window comparator
+   ******************************************************************************/
+  void handle_window_comparator_irq();
+
+  /***************************************************************************//**
+   * Interrupt handler for the triggered scan
+   ******************************************************************************/
+  void handle_triggered_scan_irq();
+
+  // The native resolution of the ADC
+  static const uint8_t native_read_resolution_bits = 12u;
+  // The maximum read resolution of the ADC with oversampling in normal mode
+  static const uint8_t oversampled_read_resolution_bits = 16u;
   // The maximum read resolution of the ADC
-  static const uint8_t max_read_resolution_bits = 12u;
+#if defined(_IADC_CFG_ADCMODE_HIGHACCURACY)
+  static const uint8_t max_read_resolution_bits = 20u;
+#else
+  static const uint8_t max_read_resolution_bits = oversampled_read_resolution_bits;
+#endif // defined(_IADC_CFG_ADCMODE_HIGHACCURACY)
+  // The maximum number of conversions averaged by the hardware
+#if defined(_IADC_CFG_DIGAVG_MASK)
+  static const uint8_t max_read_averaging = 16u;
+#else
+  static const uint8_t max_read_averaging = 1u;
+#endif // defined(_IADC_CFG_DIGAVG_MASK)
+  // The maximum number of pins in a scan
+  static const uint8_t max_scan_pins = IADC0_ENTRIES;
+  // The interrupt priority of the triggered scan - above configMAX_SYSCALL_INTERRUPT_PRIORITY
+  // and CORE_ATOMIC_BASE_PRIORITY_LEVEL, so neither the RTOS nor critical sections delay it
+  static const uint32_t triggered_scan_irq_priority = 1u;
 
 private:
   /***************************************************************************//**
-   * Initializes the ADC hardware as single shot
+   * Initializes the ADC hardware with both the single and the scan queue
    *
-   * @param[in] pin The pin number of the ADC input
-   * @param[in] reference The selected voltage reference from 'analog_references'
+   * The scan queue is set up from the current scan state if there's an active scan,
+   * the single queue keeps the current input if it was already selected.
+   *
+   * @return Status of the ADC init process
+   ******************************************************************************/
+  sl_status_t init_adc();
+
+  /***************************************************************************//**
+   * Re-initializes the ADC if it's in use and restarts the active scan
+   ******************************************************************************/
+  void reinit();
+
+  /***************************************************************************//**
+   * Stops the active scan or window comparator and releases its resources
    ******************************************************************************/
-  void init_single(PinName pin, uint8_t reference);
+  void release_scan();
 
   /***************************************************************************//**
-   * Initializes the ADC hardware in scan (continuous) mode
+   * Fills the ADC init structs from the current settings
+   *
+   * Also sets up the scan timer and calculates the millivolt conversion factors.
+   *
+   * @param[in] init The ADC init struct to be filled
+   * @param[in] all_configs The configs of the scan and the single queue to be filled
+   * @param[in] init_single The single conversion init struct to be filled
+   *
+   * @return Status of the configuration - SL_STATUS_INVALID_RANGE if the scan rate can't be reached
+   ******************************************************************************/
+  sl_status_t prepare_configs(IADC_Init_t *init, IADC_AllConfigs_t *all_configs, IADC_InitSingle_t *init_single);
+
+  /***************************************************************************//**
+   * Applies the current gain, resolution and averaging to the single queue
+   *
+   * The ADC is reconfigured without a reset, so an active scan, window comparator
+   * or triggered scan only pauses while the registers are written.
+   ******************************************************************************/
+  void update_single_config();
+
+  /***************************************************************************//**
+   * Sets the oversampling, averaging and alignment for the current read resolution
+   *
+   * @param[in] config The single conversion config to be updated
+   * @param[in] init_single The single conversion init struct to be updated
+   * @param[in] src_clk_prescale The CLK_SRC_ADC prescaler used for the ADC
+   ******************************************************************************/
+  void configure_oversampling(IADC_Config_t *config, IADC_InitSingle_t *init_single, uint8_t src_clk_prescale);
+
+  /***************************************************************************//**
+   * Switches the single conversion input of the already initialized ADC
+   *
+   * @param[in] positive_pin The pin number of the new positive ADC input
+   * @param[in] negative_pin The pin number of the new negative ADC input - PIN_NAME_NC for ground
+   ******************************************************************************/
+  void select_single_input(PinName positive_pin, PinName negative_pin);
+
+  /***************************************************************************//**
+   * Runs one conversion on the single queue - the ADC mutex has to be held
+   *
+   * @param[in] positive_pin The pin number of the positive ADC input
+   * @param[in] negative_pin The pin number of the negative ADC input - PIN_NAME_NC for ground
+   * @param[in] gain The selected analog gain from 'analog_gains'
+   *
+   * @return the raw conversion result - sign extended for differential inputs
+   ******************************************************************************/
+  int32_t convert_single(PinName positive_pin, PinName negative_pin, uint8_t gain);
+
+  /***************************************************************************//**
+   * Measures the supply voltage against the internal bandgap reference
+   *
+   * @return the AVDD supply voltage in millivolts, the nominal 3.3V if the conversion times out
+   ******************************************************************************/
+  uint32_t measure_supply_millivolts();
+
+  /***************************************************************************//**
+   * Checks whether the pins can be used as a differential input pair
+   *
+   * @param[in] positive_pin The pin number of the positive ADC input
+   * @param[in] negative_pin The pin number of the negative ADC input
+   * @param[in] gain The selected analog gain from 'analog_gains'
+   *
+   * @return true if the pair and the gain are valid
+   ******************************************************************************/
+  bool is_valid_differential_input(PinName positive_pin, PinName negative_pin, uint8_t gain);
+
+  /***************************************************************************//**
+   * Starts the scan conversions and the timer pacing them if used
+   ******************************************************************************/
+  void start_scan_conversions();
+
+  /***************************************************************************//**
+   * Calculates the window comparator threshold register value
+   *
+   * @param[in] detect_inside Match the results inside the window if true, outside if false
+   *
+   * @return The value of the IADC CMPTHR register
+   ******************************************************************************/
+  uint32_t get_window_comparator_thresholds(bool detect_inside);
+
+  /***************************************************************************//**
+   * Allocates the analog bus for the provided pin to the ADC
    *
    * @param[in] pin The pin number of the ADC input
    ******************************************************************************/
-  void init_scan(PinName pin, uint8_t reference);
+  void allocate_analog_bus(PinName pin);
+
+  /***************************************************************************//**
+   * Starts ADC in scan mode with DMA transfers of the selected width
+   *
+   * @param[in] pins Array of the ADC input pins
+   * @param[in] num_pins Number of pins in the array
+   * @param[in] buffer The buffer where the sampled data is stored
+   * @param[in] size The number of samples in the buffer
+   * @param[in] half_word Store the samples on 16 bits if true, on 32 bits otherwise
+   * @param[in] sample_rate_hz The requested per pin sample rate in Hz - 0 for continuous
+   * @param[in] user_onsampling_finished_callback Called when the buffer is full
+   *
+   * @return Status of the scan init process
+   ******************************************************************************/
+  sl_status_t start_scan(const PinName *pins, uint8_t num_pins, void *buffer, uint32_t size, bool half_word, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)());
 
   /**************************************************************************//**
    * Initializes the DMA hardware
    *
    * @param[in] buffer Pointer to the array where ADC results will be stored
    * @param[in] size Size of the array
-   * @param[in] channel Channel to use for transfer
+   * @param[in] half_word Use 16-bit transfers if true, 32-bit transfers otherwise
    *
    * @return Status of the DMA init process
    *****************************************************************************/
-  sl_status_t init_dma(uint32_t *buffer, uint32_t size);
+  sl_status_t init_dma(void *buffer, uint32_t size, bool half_word);
 
+  bool initialized_adc;
   bool initialized_single;
   bool initialized_scan;
   bool paused_transfer;
 
   PinName current_adc_pin;
+  PinName current_adc_negative_pin;
+  uint8_t current_adc_gain;
   uint8_t current_adc_reference;
   uint8_t current_read_resolution;
+  uint8_t current_read_averaging;
+  uint8_t single_conversion_resolution_bits;
+  uint32_t supply_millivolts;
+  uint32_t single_ended_millivolt_scale;
+  uint32_t differential_millivolt_scale;
+
+  PinName scan_pins[max_scan_pins];
+  uint8_t num_scan_pins;
+  uint32_t scan_sample_rate_hz;
+  uint32_t scan_src_clk_freq;
+  uint32_t scan_timer_cycles;
+  void *scan_buffer;
+  bool scan_buffer_half_words;
+
+  int scan_prs_channel;
+  uint32_t scan_overrun_count;
+  uint32_t default_irq_priority;
+
+  bool window_comparator_enabled;
+  bool window_comparator_armed_inside;
+  uint16_t window_low_threshold;
+  uint16_t window_high_threshold;
+  CMU_Select_TypeDef saved_iadc_clock;
 
   LDMA_Descriptor_t ldma_descriptor;
   unsigned int dma_channel;
   unsigned int dma_sequence_number;
 
   void (*user_onsampling_finished_callback)(void);
+  void (*user_window_comparator_callback)(bool);
+  void (*user_onsample_callback)(uint32_t);
 
   static const IADC_PosInput_t GPIO_to_ADC_pin_map[64];
 
+  // The IADC source clock (CLK_SRC_ADC) frequency requested in scan mode
+  static const uint32_t scan_src_clk_freq_target = 20000000u;
+  // The IADC conversion clock (CLK_ADC) frequency used in scan mode
+  static const uint32_t scan_adc_clk_freq_target = 10000000u;
+  // Number of CLK_ADC cycles per conversion with 2x oversampling: (4 * OSRHS) + 2
+  static const uint32_t scan_conversion_adc_clk_cycles = 10u;
+  // The IADC conversion clock (CLK_ADC) frequency used in high accuracy mode
+  static const uint32_t high_accuracy_adc_clk_freq_target = 5000000u;
+  // The largest CLK_SRC_ADC prescaler value (HSCLKRATE DIV4)
+  static const uint8_t max_src_clk_prescale = _IADC_CTRL_HSCLKRATE_DIV4;
+  // The fractional bits of the millivolt conversion factors
+  static const uint8_t millivolt_scale_shift = 24u;
+  // The internal bandgap reference voltage
+  static const uint32_t internal_reference_millivolts = 1210u;
+  // The supply voltage assumed when it can't be measured
+  static const uint32_t nominal_supply_millivolts = 3300u;
+  // The longest wait for the supply measurement - a conversion takes a few microseconds
+  static const uint32_t supply_conversion_timeout_us = 1000u;
+  // The IADC configuration used by the scan queue
+  static const uint8_t scan_config_id = 0u;
+  // The IADC configuration used by the single queue
+  static const uint8_t single_config_id = 1u;
+
   SemaphoreHandle_t adc_mutex;
   StaticSemaphore_t adc_mutex_buf;
 };
@@ -0,0 +1,235 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "analog_pipeline.h"
+
+#ifdef NUM_DAC_HW
+
+using namespace arduino;
+
+static void pipeline_sample_ready_cb(uint32_t sample);
+
+AnalogPipelineClass::AnalogPipelineClass() :
+  running(false),
+  dac(nullptr),
+  dac_channel_num(0u),
+  prs_channel(-1),
+  user_process_callback(nullptr),
+  filter(nullptr),
+  processed_count(0u),
+  output_sample(0u)
+{
+  ;
+}
+
+sl_status_t AnalogPipelineClass::begin(PinName input_pin, dac_channel_t output, uint32_t sample_rate_hz, uint32_t (*user_process_callback)(uint32_t sample))
+{
+  if (!user_process_callback) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  return this->start(input_pin, output, sample_rate_hz, user_process_callback, nullptr);
+}
+
+sl_status_t AnalogPipelineClass::begin(pin_size_t input_pin, dac_channel_t output, uint32_t sample_rate_hz, uint32_t (*user_process_callback)(uint32_t sample))
+{
+  return this->begin(pinToPinName(input_pin), output, sample_rate_hz, user_process_callback);
+}
+
+sl_status_t AnalogPipelineClass::begin(PinName input_pin, dac_channel_t output, uint32_t sample_rate_hz, BiquadFilter *filter)
+{
+  if (!filter) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  return this->start(input_pin, output, sample_rate_hz, nullptr, filter);
+}
+
+sl_status_t AnalogPipelineClass::begin(pin_size_t input_pin, dac_channel_t output, uint32_t sample_rate_hz, BiquadFilter *filter)
+{
+  return this->begin(pinToPinName(input_pin), output, sample_rate_hz, filter);
+}
+
+sl_status_t AnalogPipelineClass::start(PinName input_pin, dac_channel_t output, uint32_t sample_rate_hz, uint32_t (*user_process_callback)(uint32_t sample), BiquadFilter *filter)
+{
+  if (input_pin == PIN_NAME_NC || sample_rate_hz == 0u || sample_rate_hz > this->max_sample_rate_hz) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  // Stop the previous pipeline
+  this->end();
+
+  if (!this->select_dac(output)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  // The PRS channel carries the timer overflows to the ADC
+  CMU_ClockEnable(cmuClock_PRS, true);
+  this->prs_channel = PRS_GetFreeChannel(prsTypeAsync);
+  if (this->prs_channel < 0) {
+    return SL_STATUS_NO_MORE_RESOURCE;
+  }
+
+  this->user_process_callback = user_process_callback;
+  this->filter = filter;
+  if (this->filter) {
+    this->filter->reset();
+  }
+  this->processed_count = 0u;
+  this->output_sample = 0u;
+
+  sl_status_t status = this->dac->connect_stream_timer_prs((unsigned int)this->prs_channel);
+  if (status != SL_STATUS_OK) {
+    this->prs_channel = -1;
+    return status;
+  }
+
+  // Arm the ADC first, so it samples on the very first timer overflow
+  status = ADC.scan_start_triggered(input_pin, (unsigned int)this->prs_channel, pipeline_sample_ready_cb);
+  if (status != SL_STATUS_OK) {
+    PRS_ConnectSignal((unsigned int)this->prs_channel, prsTypeAsync, prsSignalNone);
+    this->prs_channel = -1;
+    return status;
+  }
+
+  // Loop the single output sample to the DAC - this starts the timer pacing the pipeline
+  status = this->dac->stream(this->dac_channel_num, (const uint32_t *)&this->output_sample, 1u, sample_rate_hz);
+  if (status != SL_STATUS_OK) {
+    ADC.scan_stop();
+    PRS_ConnectSignal((unsigned int)this->prs_channel, prsTypeAsync, prsSignalNone);
+    this->prs_channel = -1;
+    return status;
+  }
+
+  this->running = true;
+  return SL_STATUS_OK;
+}
+
+bool AnalogPipelineClass::select_dac(dac_channel_t output)
+{
+  switch (output) {
+    #if (NUM_DAC_HW > 0)
+    case dac_channel_t::DAC0:
+      this->dac = &DAC_0;
+      this->dac_channel_num = 0u;
+      return true;
+
+    case dac_channel_t::DAC1:
+      this->dac = &DAC_0;
+      this->dac_channel_num = 1u;
+      return true;
+    #endif // (NUM_DAC_HW > 0)
+
+    #if (NUM_DAC_HW > 1)
+    case dac_channel_t::DAC2:
+      this->dac = &DAC_1;
+      this->dac_channel_num = 0u;
+      return true;
+
+    case dac_channel_t::DAC3:
+      this->dac = &DAC_1;
+      this->dac_channel_num = 1u;
+      return true;
+    #endif // (NUM_DAC_HW > 1)
+
+    default:
+      return false;
+  }
+}
+
+void AnalogPipelineClass::end()
+{
+  if (!this->running) {
+    return;
+  }
+
+  // Stop the processing first, then the output
+  ADC.scan_stop();
+  this->dac->stream_stop(this->dac_channel_num);
+  PRS_ConnectSignal((unsigned int)this->prs_channel, prsTypeAsync, prsSignalNone);
+
+  this->prs_channel = -1;
+  this->user_process_callback = nullptr;
+  this->filter = nullptr;
+  this->running = false;
+}
+
+bool AnalogPipelineClass::is_running()
+{
+  return this->running;
+}
+
+float AnalogPipelineClass::get_sample_rate()
+{
+  if (!this->running) {
+    return 0.0f;
+  }
+  return this->dac->get_stream_sample_rate();
+}
+
+uint32_t AnalogPipelineClass::get_latency_samples()
+{
+  return this->latency_samples;
+}
+
+uint32_t AnalogPipelineClass::get_processed_count()
+{
+  return this->processed_count;
+}
+
+uint32_t AnalogPipelineClass::get_overrun_count()
+{
+  if (!this->running) {
+    return 0u;
+  }
+  return ADC.get_scan_overrun_count();
+}
+
+void AnalogPipelineClass::handle_sample(uint32_t sample)
+{
+  uint32_t result;
+  if (this->filter) {
+    result = this->filter->process_unsigned(sample, AdcClass::native_read_resolution_bits);
+  } else if (this->user_process_callback) {
+    result = this->user_process_callback(sample);
+  } else {
+    return;
+  }
+
+  if (result > this->max_output_value) {
+    result = this->max_output_value;
+  }
+  // The LDMA writes it to the DAC on the next timer overflow
+  this->output_sample = result;
+  this->processed_count = this->processed_count + 1u;
+}
+
+static void pipeline_sample_ready_cb(uint32_t sample)
+{
+  AnalogPipeline.handle_sample(sample);
+}
+
+arduino::AnalogPipelineClass AnalogPipeline;
+
+#endif // NUM_DAC_HW
@@ -0,0 +1,184 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Arduino.h"
+
+#ifndef __ARDUINO_ANALOG_PIPELINE_H
+#define __ARDUINO_ANALOG_PIPELINE_H
+
+#ifdef NUM_DAC_HW
+
+#include "adc.h"
+#include "dac.h"
+#include "biquad.h"
+#include "em_prs.h"
+#include "sl_status.h"
+
+namespace arduino {
+class AnalogPipelineClass {
+public:
+  /***************************************************************************//**
+   * Constructor for AnalogPipelineClass
+   ******************************************************************************/
+  AnalogPipelineClass();
+
+  /***************************************************************************//**
+   * Starts sampling a pin, processing the samples and writing the results to a DAC channel
+   *
+   * The stream timer of the DAC paces the whole pipeline. On every timer overflow
+   * the ADC samples the input through the PRS and the LDMA writes the previous
+   * result to the DAC at the same time. The sample is processed in the ADC
+   * interrupt, so every input sample appears on the output exactly
+   * 'latency_samples' sample periods after it was taken, regardless of the CPU load.
+   * The callback runs above the RTOS interrupt priority - it must not call any
+   * RTOS APIs and it has to return within one sample period.
+   * The pipeline uses the ADC scan, so it can't run together with analogReadDMA(),
+   * and the DAC channel can't be streamed or written while it runs.
+   *
+   * @param[in] input_pin The analog input pin
+   * @param[in] output The DAC channel driven by the pipeline
+   * @param[in] sample_rate_hz The requested sample rate in Hz
+   * @param[in] user_process_callback Called with every 12-bit ADC sample,
+   *            returns the 12-bit DAC sample
+   *
+   * @return Status of the pipeline start process
+   ******************************************************************************/
+  sl_status_t begin(PinName input_pin, dac_channel_t output, uint32_t sample_rate_hz, uint32_t (*user_process_callback)(uint32_t sample));
+  sl_status_t begin(pin_size_t input_pin, dac_channel_t output, uint32_t sample_rate_hz, uint32_t (*user_process_callback)(uint32_t sample));
+
+  /***************************************************************************//**
+   * Starts the pipeline with a fixed-point biquad filter as the processing stage
+   *
+   * The filter is reset and then processes the samples around the mid scale.
+   * The filter must stay valid until the pipeline is stopped.
+   *
+   * @param[in] input_pin The analog input pin
+   * @param[in] output The DAC channel driven by the pipeline
+   * @param[in] sample_rate_hz The requested sample rate in Hz
+   * @param[in] filter The configured filter processing the samples
+   *
+   * @return Status of the pipeline start process
+   ******************************************************************************/
+  sl_status_t begin(PinName input_pin, dac_channel_t output, uint32_t sample_rate_hz, BiquadFilter *filter);
+  sl_status_t begin(pin_size_t input_pin, dac_channel_t output, uint32_t sample_rate_hz, BiquadFilter *filter);
+
+  /***************************************************************************//**
+   * Stops the pipeline - the DAC output keeps the last sample
+   ******************************************************************************/
+  void end();
+
+  /***************************************************************************//**
+   * Returns whether the pipeline is running
+   *
+   * @return true if the pipeline is running
+   ******************************************************************************/
+  bool is_running();
+
+  /***************************************************************************//**
+   * Returns the sample rate achieved by the pipeline
+   *
+   * @return the sample rate in Hz, 0 if the pipeline is not running
+   ******************************************************************************/
+  float get_sample_rate();
+
+  /***************************************************************************//**
+   * Returns the delay between taking an input sample and outputting its result
+   *
+   * @return the latency in sample periods
+   ******************************************************************************/
+  uint32_t get_latency_samples();
+
+  /***************************************************************************//**
+   * Returns the number of samples processed since the pipeline was started
+   *
+   * @return the number of processed samples
+   ******************************************************************************/
+  uint32_t get_processed_count();
+
+  /***************************************************************************//**
+   * Returns the number of samples whose processing took longer than a sample period
+   *
+   * The DAC kept its previous value for one period after each overrun.
+   *
+   * @return the number of overruns since the pipeline was started
+   ******************************************************************************/
+  uint32_t get_overrun_count();
+
+  /***************************************************************************//**
+   * Processes an ADC sample and queues the result for the next DAC update
+   *
+   * @param[in] sample The 12-bit ADC sample
+   ******************************************************************************/
+  void handle_sample(uint32_t sample);
+
+  // The results are written to the DAC on the timer overflow after the sample was taken
+  static const uint32_t latency_samples = 1u;
+  // The highest sample rate leaving enough time to process a sample
+  static const uint32_t max_sample_rate_hz = 100000u;
+
+private:
+  /***************************************************************************//**
+   * Starts the pipeline with the selected processing stage
+   *
+   * @param[in] input_pin The analog input pin
+   * @param[in] output The DAC channel driven by the pipeline
+   * @param[in] sample_rate_hz The requested sample rate in Hz
+   * @param[in] user_process_callback The processing callback - nullptr if a filter is used
+   * @param[in] filter The processing filter - nullptr if a callback is used
+   *
+   * @return Status of the pipeline start process
+   ******************************************************************************/
+  sl_status_t start(PinName input_pin, dac_channel_t output, uint32_t sample_rate_hz, uint32_t (*user_process_callback)(uint32_t sample), BiquadFilter *filter);
+
+  /***************************************************************************//**
+   * Selects the DAC peripheral and channel of a DAC output
+   *
+   * @param[in] output The DAC output
+   *
+   * @return true if the output is available
+   ******************************************************************************/
+  bool select_dac(dac_channel_t output);
+
+  bool running;
+  DacClass* dac;
+  uint8_t dac_channel_num;
+  int prs_channel;
+  uint32_t (*user_process_callback)(uint32_t sample);
+  BiquadFilter* filter;
+  volatile uint32_t processed_count;
+  // The result waiting for the next timer overflow - the LDMA copies it to the DAC from here
+  volatile uint32_t output_sample;
+
+  // The largest value the DAC accepts
+  static const uint32_t max_output_value = (1u << AdcClass::native_read_resolution_bits) - 1u;
+};
+} // namespace arduino
+
+extern arduino::AnalogPipelineClass AnalogPipeline;
+
+#endif // NUM_DAC_HW
+
+#endif // __ARDUINO_ANALOG_PIPELINE_H
@@ -0,0 +1,364 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __ARDUINO_BIQUAD_H
+#define __ARDUINO_BIQUAD_H
+
+// This file doesn't depend on the hardware, so the filters can be tested on the host as well
+#include <cmath>
+#include <inttypes.h>
+
+namespace arduino {
+class BiquadFilter {
+public:
+
+  /***************************************************************************//**
+   * Constructor for BiquadFilter
+   * The filter passes the samples through unchanged until it's configured.
+   ******************************************************************************/
+  BiquadFilter() :
+    b0(1 << coefficient_shift),
+    b1(0),
+    b2(0),
+    a1(0),
+    a2(0)
+  {
+    this->reset();
+  }
+
+  /***************************************************************************//**
+   * Sets the coefficients of the filter normalized to a0 = 1
+   *
+   * y[n] = b0 * x[n] + b1 * x[n-1] + b2 * x[n-2] - a1 * y[n-1] - a2 * y[n-2]
+   * The coefficients are stored in fixed-point, so they have to be in the range of +-8.
+   *
+   * @param[in] b0 The b0 coefficient
+   * @param[in] b1 The b1 coefficient
+   * @param[in] b2 The b2 coefficient
+   * @param[in] a1 The a1 coefficient
+   * @param[in] a2 The a2 coefficient
+   *
+   * @return true if the coefficients were applied, false if any of them is out of range
+   ******************************************************************************/
+  bool set_coefficients(float b0, float b1, float b2, float a1, float a2)
+  {
+    int32_t fixed[5];
+    const float coefficients[5] = { b0, b1, b2, a1, a2 };
+    for (uint8_t i = 0u; i < 5u; i++) {
+      if (!to_fixed(coefficients[i], &fixed[i])) {
+        return false;
+      }
+    }
+    this->apply_coefficients(fixed);
+    return true;
+  }
+
+  /***************************************************************************//**
+   * Configures the filter as a second order low-pass filter
+   *
+   * @param[in] sample_rate_hz The sample rate of the filtered signal in Hz
+   * @param[in] cutoff_hz The cutoff frequency in Hz
+   * @param[in] q The quality factor - 0.7071 for a Butterworth response
+   *
+   * @return true if the filter was configured, false if the parameters are invalid
+   ******************************************************************************/
+  bool set_lowpass(float sample_rate_hz, float cutoff_hz, float q)
+  {
+    return this->set_response(filter_lowpass, sample_rate_hz, cutoff_hz, q);
+  }
+
+  /***************************************************************************//**
+   * Configures the filter as a second order high-pass filter
+   *
+   * @param[in] sample_rate_hz The sample rate of the filtered signal in Hz
+   * @param[in] cutoff_hz The cutoff frequency in Hz
+   * @param[in] q The quality factor - 0.7071 for a Butterworth response
+   *
+   * @return true if the filter was configured, false if the parameters are invalid
+   ******************************************************************************/
+  bool set_highpass(float sample_rate_hz, float cutoff_hz, float q)
+  {
+    return this->set_response(filter_highpass, sample_rate_hz, cutoff_hz, q);
+  }
+
+  /***************************************************************************//**
+   * Configures the filter as a band-pass filter with 0dB gain at the center
+   *
+   * @param[in] sample_rate_hz The sample rate of the filtered signal in Hz
+   * @param[in] center_hz The center frequency in Hz
+   * @param[in] q The quality factor - the center frequency divided by the bandwidth
+   *
+   * @return true if the filter was configured, false if the parameters are invalid
+   ******************************************************************************/
+  bool set_bandpass(float sample_rate_hz, float center_hz, float q)
+  {
+    return this->set_response(filter_bandpass, sample_rate_hz, center_hz, q);
+  }
+
+  /***************************************************************************//**
+   * Configures the filter as a notch filter
+   *
+   * @param[in] sample_rate_hz The sample rate of the filtered signal in Hz
+   * @param[in] center_hz The rejected frequency in Hz
+   * @param[in] q The quality factor - the center frequency divided by the bandwidth
+   *
+   * @return true if the filter was configured, false if the parameters are invalid
+   ******************************************************************************/
+  bool set_notch(float sample_rate_hz, float center_hz, float q)
+  {
+    return this->set_response(filter_notch, sample_rate_hz, center_hz, q);
+  }
+
+  /***************************************************************************//**
+   * Clears the history of the filter
+   ******************************************************************************/
+  void reset()
+  {
+    this->x1 = 0;
+    this->x2 = 0;
+    this->y1 = 0;
+    this->y2 = 0;
+    this->error = 0;
+  }
+
+  /***************************************************************************//**
+   * Filters a signed sample
+   *
+   * The filter uses integer math only. The history is kept with extra fractional
+   * bits and the rounding error of each step is fed back into the next one, so
+   * there's no DC error or dead band even at low cutoffs.
+   *
+   * @param[in] sample The next input sample - limited to +-'max_sample_value'
+   *
+   * @return the next output sample
+   ******************************************************************************/
+  int32_t process(int32_t sample)
+  {
+    if (sample > max_sample_value) {
+      sample = max_sample_value;
+    } else if (sample < -max_sample_value) {
+      sample = -max_sample_value;
+    }
+    int32_t input = sample * (1 << state_shift);
+
+    int64_t acc = (int64_t)this->b0 * input
+                  + (int64_t)this->b1 * this->x1
+                  + (int64_t)this->b2 * this->x2
+                  - (int64_t)this->a1 * this->y1
+                  - (int64_t)this->a2 * this->y2
+                  + this->error;
+    int64_t output = acc >> coefficient_shift;
+    this->error = acc - (output * ((int64_t)1 << coefficient_shift));
+
+    // Saturate instead of wrapping around if the filter is driven beyond its range
+    if (output > INT32_MAX) {
+      output = INT32_MAX;
+    } else if (output < INT32_MIN) {
+      output = INT32_MIN;
+    }
+
+    this->x2 = this->x1;
+    this->x1 = input;
+    this->y2 = this->y1;
+    this->y1 = (int32_t)output;
+    // Round away the extra fractional bits
+    return (int32_t)((output + (1 << (state_shift - 1u))) >> state_shift);
+  }
+
+  /***************************************************************************//**
+   * Filters an unsigned sample around the middle of its range
+   *
+   * Useful for filtering ADC samples into DAC samples - the mid scale is treated as
+   * zero, so filters blocking DC settle to the middle of the output range.
+   *
+   * @param[in] sample The next input sample
+   * @param[in] resolution_bits The resolution of the input and the output samples
+   *
+   * @return the next output sample clamped to the range of the resolution
+   ******************************************************************************/
+  uint32_t process_unsigned(uint32_t sample, uint8_t resolution_bits)
+  {
+    const int32_t mid_scale = (int32_t)(1u << (resolution_bits - 1u));
+    const int32_t max_value = (int32_t)((1u << resolution_bits) - 1u);
+    int32_t output = this->process((int32_t)sample - mid_scale) + mid_scale;
+    if (output < 0) {
+      output = 0;
+    } else if (output > max_value) {
+      output = max_value;
+    }
+    return (uint32_t)output;
+  }
+
+  // The fractional bits of the fixed-point coefficients
+  static const uint8_t coefficient_shift = 28u;
+  // The extra fractional bits of the filter history
+  static const uint8_t state_shift = 8u;
+  // The largest magnitude of the samples
+  static const int32_t max_sample_value = INT32_MAX >> state_shift;
+
+private:
+  enum filter_response {
+    filter_lowpass,
+    filter_highpass,
+    filter_bandpass,
+    filter_notch
+  };
+
+  /***************************************************************************//**
+   * Calculates the coefficients of a standard filter response
+   *
+   * @param[in] response The requested filter response
+   * @param[in] sample_rate_hz The sample rate of the filtered signal in Hz
+   * @param[in] frequency_hz The cutoff or center frequency in Hz
+   * @param[in] q The quality factor
+   *
+   * @return true if the filter was configured, false if the parameters are invalid
+   ******************************************************************************/
+  bool set_response(filter_response response, float sample_rate_hz, float frequency_hz, float q)
+  {
+    if (!(sample_rate_hz > 0.0f) || !(frequency_hz > 0.0f) || !(frequency_hz < sample_rate_hz / 2.0f) || !(q > 0.0f)) {
+      return false;
+    }
+
+    // Bilinear transform of the analog prototypes with prewarping to the requested frequency
+    // Calculated in double precision - low cutoffs need the small differences between the coefficients
+    const double pi = 3.14159265358979;
+    double w0 = 2.0 * pi * (double)frequency_hz / (double)sample_rate_hz;
+    double cos_w0 = std::cos(w0);
+    double alpha = std::sin(w0) / (2.0 * (double)q);
+    double a0 = 1.0 + alpha;
+    double b0;
+
+    switch (response) {
+      case filter_lowpass:
+        b0 = (1.0 - cos_w0) / 2.0;
+        break;
+
+      case filter_highpass:
+        b0 = (1.0 + cos_w0) / 2.0;
+        break;
+
+      case filter_bandpass:
+        b0 = alpha;
+        break;
+
+      case filter_notch:
+      default:
+        b0 = 1.0;
+        break;
+    }
+
+    // b0, b1, b2, a1, a2
+    int32_t fixed[5];
+    if (!to_fixed(b0 / a0, &fixed[0])
+        || !to_fixed((-2.0 * cos_w0) / a0, &fixed[3])
+        || !to_fixed((1.0 - alpha) / a0, &fixed[4])) {
+      return false;
+    }
+
+    // Derive the rest of the numerator from the rounded coefficients, so the gain at DC is exact
+    // The gain at DC is the sum of the numerator divided by the sum of the denominator
+    int32_t denominator_sum = (1 << coefficient_shift) + fixed[3] + fixed[4];
+    switch (response) {
+      case filter_lowpass:
+        // Unity gain - the numerator is b0 * (1, 2, 1), which adds up to the denominator
+        fixed[0] = denominator_sum / 4;
+        fixed[1] = denominator_sum - (2 * fixed[0]);
+        fixed[2] = fixed[0];
+        break;
+
+      case filter_highpass:
+        // Zero gain - the numerator is b0 * (1, -2, 1)
+        fixed[1] = -2 * fixed[0];
+        fixed[2] = fixed[0];
+        break;
+
+      case filter_bandpass:
+        // Zero gain - the numerator is b0 * (1, 0, -1)
+        fixed[1] = 0;
+        fixed[2] = -fixed[0];
+        break;
+
+      case filter_notch:
+      default:
+        // Unity gain - the numerator is b0 * (1, -2 * cos(w0), 1), which adds up to the denominator
+        fixed[2] = fixed[0];
+        fixed[1] = denominator_sum - (2 * fixed[0]);
+        break;
+    }
+
+    this->apply_coefficients(fixed);
+    return true;
+  }
+
+  /***************************************************************************//**
+   * Converts a coefficient to the fixed-point format
+   *
+   * @param[in] coefficient The coefficient
+   * @param[out] fixed The coefficient in fixed-point
+   *
+   * @return true if the coefficient is in range
+   ******************************************************************************/
+  static bool to_fixed(double coefficient, int32_t *fixed)
+  {
+    double scaled = coefficient * (double)(1 << coefficient_shift);
+    if (!(std::fabs(scaled) <= (double)INT32_MAX)) {
+      return false;
+    }
+    *fixed = (int32_t)std::lround(scaled);
+    return true;
+  }
+
+  /***************************************************************************//**
+   * Applies the fixed-point coefficients and clears the history
+   *
+   * @param[in] fixed The b0, b1, b2, a1 and a2 coefficients in fixed-point
+   ******************************************************************************/
+  void apply_coefficients(const int32_t fixed[5])
+  {
+    this->b0 = fixed[0];
+    this->b1 = fixed[1];
+    this->b2 = fixed[2];
+    this->a1 = fixed[3];
+    this->a2 = fixed[4];
+    this->reset();
+  }
+
+  int32_t b0;
+  int32_t b1;
+  int32_t b2;
+  int32_t a1;
+  int32_t a2;
+
+  int32_t x1;
+  int32_t x2;
+  int32_t y1;
+  int32_t y2;
+  int64_t error;
+};
+} // namespace arduino
+
+#endif // __ARDUINO_BIQUAD_H
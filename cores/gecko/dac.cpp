@@ -29,10 +29,14 @@
 #ifdef NUM_DAC_HW
 
 #include "arduino_dac_config.h"
+#include "em_core.h"
 
 using namespace arduino;
 
-DacClass::DacClass(VDAC_TypeDef *vdac_peripheral, PinName ch0_pin, PinName ch1_pin) :
+static bool stream_dma_transfer_finished_cb(unsigned int channel, unsigned int sequenceNo, void *userParam);
+static bool get_timer_overflow_prs_signal(TIMER_TypeDef* timer, PRS_Signal_t* signal);
+
+DacClass::DacClass(VDAC_TypeDef *vdac_peripheral, PinName ch0_pin, PinName ch1_pin, TIMER_TypeDef *stream_timer) :
   dac_initialized(false),
   ch0_pin(ch0_pin),
   ch1_pin(ch1_pin),
@@ -43,9 +47,20 @@ DacClass::DacClass(VDAC_TypeDef *vdac_peripheral, PinName ch0_pin, PinName ch1_p
   auto_deinit(true),
   write_resolution(8),
   dac_max_value(255),
-  voltage_ref(vdacRef1V25)
+  voltage_ref(vdacRef1V25),
+  stream_timer(stream_timer),
+  stream_sample_rate_hz(0u),
+  stream_timer_freq(0u),
+  stream_timer_cycles(0u)
 {
   this->vdac_peripheral = vdac_peripheral;
+  for (auto& stream : this->streams) {
+    stream.active = false;
+    stream.dma_channel = 0u;
+    stream.buffer = nullptr;
+    stream.half_len = 0u;
+    stream.user_refill_callback = nullptr;
+  }
 }
 
 void DacClass::set_output(uint8_t channel_num, uint32_t value)
@@ -54,16 +69,15 @@ void DacClass::set_output(uint8_t channel_num, uint32_t value)
     return;
   }
 
+  // Writing a value manually ends the stream on the channel
+  this->stream_stop(channel_num);
+
   if (value == 0 && this->auto_deinit) {
     this->deinit(channel_num);
     return;
   }
 
-  // Map the value from the current write resolution to 12 bits (true resolution)
-  uint32_t value_out = value;
-  if (this->write_resolution != this->dac_true_bit_resolution) {
-    value_out = map(value, 0, this->dac_max_value, 0, this->dac_true_max_value);
-  }
+  uint32_t value_out = this->map_to_true_resolution(value);
 
   this->init(channel_num);
   VDAC_ChannelOutputSet(this->vdac_peripheral, channel_num, value_out);
@@ -76,75 +90,121 @@ void DacClass::set_output(uint8_t channel_num, uint32_t value)
   }
 }
 
-void DacClass::init(uint8_t channel_num)
+void DacClass::set_outputs(uint32_t ch0_value, uint32_t ch1_value)
 {
-  // Initialize the peripheral
-  if (!this->dac_initialized) {
-    // Use default settings
-    VDAC_Init_TypeDef init = VDAC_INIT_DEFAULT;
-
-    // Set the configured voltage reference
-    init.reference = this->voltage_ref;
-
-    // Use the HFRCOEM23 to clock the VDAC in order to operate in EM3 mode
-    if (this->vdac_peripheral == VDAC0) {
-      CMU_ClockSelectSet(cmuClock_VDAC0, cmuSelect_HFRCOEM23);
-    } else if (this->vdac_peripheral == VDAC1) {
-      CMU_ClockSelectSet(cmuClock_VDAC1, cmuSelect_HFRCOEM23);
-    } else {
-      return;
-    }
+  if (ch0_value > this->dac_max_value || ch1_value > this->dac_max_value) {
+    return;
+  }
 
-    // Enable the HFRCOEM23 and VDAC clocks
-    CMU_ClockEnable(cmuClock_HFRCOEM23, true);
+  // Writing values manually ends the streams
+  this->stream_stop(0);
+  this->stream_stop(1);
 
-    // Enable the VDAC peripheral clock
-    if (this->vdac_peripheral == VDAC0) {
-      CMU_ClockEnable(cmuClock_VDAC0, true);
-    } else if (this->vdac_peripheral == VDAC1) {
-      CMU_ClockEnable(cmuClock_VDAC1, true);
-    } else {
-      return;
-    }
+  this->ch0_value = this->map_to_true_resolution(ch0_value);
+  this->ch1_value = this->map_to_true_resolution(ch1_value);
+
+  // Both channels stay enabled - the auto deinit doesn't apply here
+  this->init(0);
+  this->init(1);
+  if (!this->ch0_initialized || !this->ch1_initialized) {
+    return;
+  }
 
-    // Calculate the VDAC clock prescaler value resulting in a 1 MHz VDAC clock
-    init.prescaler = VDAC_PrescaleCalc(this->vdac_peripheral, this->vdac_max_freq);
+  // Write both FIFOs with back-to-back writes without being interrupted, so the
+  // channels are updated within a few bus cycles of each other
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  this->vdac_peripheral->CH0F = this->ch0_value;
+  this->vdac_peripheral->CH1F = this->ch1_value;
+  CORE_EXIT_ATOMIC();
+}
 
-    // Clocking is requested on demand
-    init.onDemandClk = false;
+uint32_t DacClass::map_to_true_resolution(uint32_t value)
+{
+  // Map the value from the current write resolution to 12 bits (true resolution)
+  if (this->write_resolution == this->dac_true_bit_resolution) {
+    return value;
+  }
+  return map(value, 0, this->dac_max_value, 0, this->dac_true_max_value);
+}
 
-    // Initialize the VDAC and VDAC channel
-    VDAC_Init(this->vdac_peripheral, &init);
+void DacClass::init(uint8_t channel_num)
+{
+  if (channel_num > 1) {
+    return;
+  }
 
-    this->dac_initialized = true;
+  // Initialize the peripheral
+  if (!this->dac_initialized) {
+    this->init_peripheral();
+    if (!this->dac_initialized) {
+      return;
+    }
   }
 
-  // Initialize the requested channel
+  // Enable the requested channel - the other channel is not affected
   if (channel_num == 0 && !this->ch0_initialized) {
-    this->init_channel(0);
+    this->enable_channel(0);
   }
   if (channel_num == 1 && !this->ch1_initialized) {
-    this->init_channel(1);
+    this->enable_channel(1);
   }
 }
 
-void DacClass::init_channel(uint8_t channel_num)
+void DacClass::init_peripheral()
 {
-  if (channel_num > 1) {
+  // Use default settings
+  VDAC_Init_TypeDef init = VDAC_INIT_DEFAULT;
+
+  // Set the configured voltage reference
+  init.reference = this->voltage_ref;
+
+  // Use the HFRCOEM23 to clock the VDAC in order to operate in EM3 mode
+  if (this->vdac_peripheral == VDAC0) {
+    CMU_ClockSelectSet(cmuClock_VDAC0, cmuSelect_HFRCOEM23);
+  } else if (this->vdac_peripheral == VDAC1) {
+    CMU_ClockSelectSet(cmuClock_VDAC1, cmuSelect_HFRCOEM23);
+  } else {
     return;
   }
 
-  // Set the DAC output pin's mode to 'gpioModeWiredOr'
-  if (channel_num == 0) {
-    GPIO_PinModeSet(getSilabsPortFromArduinoPin(this->ch0_pin), getSilabsPinFromArduinoPin(this->ch0_pin), gpioModeWiredOr, 0);
-  }
-  if (channel_num == 1) {
-    GPIO_PinModeSet(getSilabsPortFromArduinoPin(this->ch1_pin), getSilabsPinFromArduinoPin(this->ch1_pin), gpioModeWiredOr, 0);
+  // Enable the HFRCOEM23 and VDAC clocks
+  CMU_ClockEnable(cmuClock_HFRCOEM23, true);
+
+  // Enable the VDAC peripheral clock
+  if (this->vdac_peripheral == VDAC0) {
+    CMU_ClockEnable(cmuClock_VDAC0, true);
+  } else if (this->vdac_peripheral == VDAC1) {
+    CMU_ClockEnable(cmuClock_VDAC1, true);
+  } else {
+    return;
   }
 
+  // Calculate the VDAC clock prescaler value resulting in a 1 MHz VDAC clock
+  init.prescaler = VDAC_PrescaleCalc(this->vdac_peripheral, this->vdac_max_freq);
+
+  // Clocking is requested on demand
+  init.onDemandClk = false;
+
+  // Initialize the VDAC
+  VDAC_Init(this->vdac_peripheral, &init);
+
+  // Configure both channels up front - the channel config can only be written while
+  // the whole VDAC is disabled, enabling a channel later doesn't disturb the other one
+  this->configure_channel(0);
+  this->configure_channel(1);
+
+  this->dac_initialized = true;
+}
+
+void DacClass::configure_channel(uint8_t channel_num)
+{
   // Use default settings
   VDAC_InitChannel_TypeDef initChannel = VDAC_INITCHANNEL_DEFAULT;
 
+  // Leave the channel disabled until it's used
+  initChannel.enable = false;
+
   // Disable High Capacitance Load mode
   initChannel.highCapLoadEnable = false;
 
@@ -152,8 +212,19 @@ void DacClass::init_channel(uint8_t channel_num)
   initChannel.powerMode = vdacPowerModeLowPower;
 
   VDAC_InitChannel(this->vdac_peripheral, &initChannel, channel_num);
+}
 
-  // Enable the VDAC
+void DacClass::enable_channel(uint8_t channel_num)
+{
+  if (channel_num > 1) {
+    return;
+  }
+
+  // Set the DAC output pin's mode to 'gpioModeWiredOr'
+  PinName pin = (channel_num == 0) ? this->ch0_pin : this->ch1_pin;
+  GPIO_PinModeSet(getSilabsPortFromArduinoPin(pin), getSilabsPinFromArduinoPin(pin), gpioModeWiredOr, 0);
+
+  // Enable the channel
   VDAC_Enable(this->vdac_peripheral, channel_num, true);
 
   if (channel_num == 0) {
@@ -176,26 +247,24 @@ void DacClass::deinit(uint8_t channel_num)
     return;
   }
 
-  // Reset the whole hardware - we don't have the means to deinitialize a separate channel
-  // The other channel which is still enabled will jump to 0V for a brief moment while it's reinitialized
-  VDAC_Reset(this->vdac_peripheral);
-  this->dac_initialized = false;
+  this->stream_stop(channel_num);
+
+  // Only disable the requested channel - the other channel keeps its output
+  VDAC_Enable(this->vdac_peripheral, channel_num, false);
+  PinName pin = (channel_num == 0) ? this->ch0_pin : this->ch1_pin;
+  GPIO_PinModeSet(getSilabsPortFromArduinoPin(pin), getSilabsPinFromArduinoPin(pin), gpioModeDisabled, 0);
 
-  // Reinitialize the other channel if it's still enabled
   if (channel_num == 0) {
     this->ch0_initialized = false;
-    if (this->ch1_initialized) {
-      this->ch1_initialized = false;
-      this->set_output(1, this->ch1_value);
-    }
   }
-
   if (channel_num == 1) {
     this->ch1_initialized = false;
-    if (this->ch0_initialized) {
-      this->ch0_initialized = false;
-      this->set_output(0, this->ch0_value);
-    }
+  }
+
+  // Power down the whole VDAC when none of the channels are used
+  if (!this->ch0_initialized && !this->ch1_initialized) {
+    VDAC_Reset(this->vdac_peripheral);
+    this->dac_initialized = false;
   }
 }
 
@@ -215,36 +284,323 @@ void DacClass::set_write_resolution(uint8_t resolution)
 
 void DacClass::set_voltage_reference(dac_voltage_ref_t reference)
 {
-  // Deinitialize both channels
-  this->deinit(0);
-  this->deinit(1);
-
+  VDAC_Ref_TypeDef voltage_ref;
   switch (reference) {
     case DAC_VREF_1V25:
-      this->voltage_ref = vdacRef1V25;
+      voltage_ref = vdacRef1V25;
       break;
     case DAC_VREF_2V5:
-      this->voltage_ref = vdacRef2V5;
+      voltage_ref = vdacRef2V5;
       break;
     case DAC_VREF_AVDD:
-      this->voltage_ref = vdacRefAvdd;
+      voltage_ref = vdacRefAvdd;
       break;
     case DAC_VREF_EXTERNAL_PIN:
-      this->voltage_ref = vdacRefExtPin;
+      voltage_ref = vdacRefExtPin;
       break;
 
     default:
-      this->voltage_ref = vdacRef1V25;
+      voltage_ref = vdacRef1V25;
       break;
   }
+
+  if (voltage_ref == this->voltage_ref) {
+    return;
+  }
+  this->voltage_ref = voltage_ref;
+
+  if (!this->dac_initialized) {
+    return;
+  }
+
+  // The reference can only be changed while the VDAC is disabled
+  // Reinitialize it and restore the enabled channels with their last values right away
+  bool ch0_enabled = this->ch0_initialized;
+  bool ch1_enabled = this->ch1_initialized;
+  VDAC_Reset(this->vdac_peripheral);
+  this->dac_initialized = false;
+  this->ch0_initialized = false;
+  this->ch1_initialized = false;
+
+  if (ch0_enabled) {
+    this->init(0);
+    VDAC_ChannelOutputSet(this->vdac_peripheral, 0, this->ch0_value);
+  }
+  if (ch1_enabled) {
+    this->init(1);
+    VDAC_ChannelOutputSet(this->vdac_peripheral, 1, this->ch1_value);
+  }
+}
+
+sl_status_t DacClass::stream(uint8_t channel_num, uint32_t *buffer, uint32_t len, uint32_t sample_rate_hz, void (*user_refill_callback)(uint32_t *half_buffer, uint32_t half_len))
+{
+  if (!user_refill_callback) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  return this->start_stream(channel_num, buffer, len, sample_rate_hz, user_refill_callback);
+}
+
+sl_status_t DacClass::stream(uint8_t channel_num, const uint32_t *table, uint32_t len, uint32_t sample_rate_hz)
+{
+  return this->start_stream(channel_num, table, len, sample_rate_hz, nullptr);
+}
+
+sl_status_t DacClass::start_stream(uint8_t channel_num, const uint32_t *buffer, uint32_t len, uint32_t sample_rate_hz, void (*user_refill_callback)(uint32_t *half_buffer, uint32_t half_len))
+{
+  bool ping_pong = (user_refill_callback != nullptr);
+  if (channel_num > 1 || !buffer || len == 0u || sample_rate_hz == 0u) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  // The ping-pong buffer is played in two equal halves
+  if (ping_pong && (len < 2u || (len % 2u) != 0u)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  uint32_t descriptor_len = ping_pong ? (len / 2u) : len;
+  if (descriptor_len > (uint32_t)DMADRV_MAX_XFER_COUNT) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  // Both channels are paced by the same timer - check before touching the running stream
+  uint8_t other_channel_num = 1u - channel_num;
+  bool other_channel_streaming = this->is_streaming(other_channel_num);
+  if (other_channel_streaming && sample_rate_hz != this->stream_sample_rate_hz) {
+    return SL_STATUS_INVALID_STATE;
+  }
+
+  LDMA_PeripheralSignal_t timer_overflow_signal;
+  if (!TimerAllocatorClass::get_overflow_dma_signal(this->stream_timer, &timer_overflow_signal)) {
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+
+  // Restart the stream if the channel is already streaming
+  this->stream_stop(channel_num);
+
+  // Power up the channel - the samples written by the DMA are converted right away
+  // A channel powered up only for this stream is powered down again if the stream can't start
+  bool channel_was_initialized = (channel_num == 0u) ? this->ch0_initialized : this->ch1_initialized;
+  this->init(channel_num);
+  if (!this->dac_initialized) {
+    return SL_STATUS_FAIL;
+  }
+
+  dac_stream_t *stream = &this->streams[channel_num];
+
+  // Initialize DMA with default parameters
+  DMADRV_Init();
+
+  // Allocate DMA channel
+  if (DMADRV_AllocateChannel(&stream->dma_channel, NULL) != ECODE_EMDRV_DMADRV_OK) {
+    if (!channel_was_initialized) {
+      this->deinit(channel_num);
+    }
+    return SL_STATUS_NO_MORE_RESOURCE;
+  }
+
+  if (!other_channel_streaming) {
+    sl_status_t status = this->start_stream_timer(sample_rate_hz);
+    if (status != SL_STATUS_OK) {
+      DMADRV_FreeChannel(stream->dma_channel);
+      if (!channel_was_initialized) {
+        this->deinit(channel_num);
+      }
+      return status;
+    }
+    #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
+    // Require at least EM1 to keep the timer and the LDMA running
+    sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
+    #endif // SL_CATALOG_POWER_MANAGER_PRESENT
+  }
+
+  volatile uint32_t *fifo = (channel_num == 0u) ? &this->vdac_peripheral->CH0F : &this->vdac_peripheral->CH1F;
+
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+  if (ping_pong) {
+    // Two descriptors linked to each other - each raises an interrupt when its half has been played
+    stream->descriptors[0] = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(buffer, fifo, descriptor_len, 1);
+    stream->descriptors[1] = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(buffer + descriptor_len, fifo, descriptor_len, -1);
+  } else {
+    // A single descriptor linked to itself without interrupts loops the table without any CPU involvement
+    stream->descriptors[0] = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(buffer, fifo, descriptor_len, 0);
+    stream->descriptors[0].xfer.doneIfs = 0;
+  }
+  #pragma GCC diagnostic pop
+  // Write one 32-bit FIFO entry on every timer overflow
+  stream->descriptors[0].xfer.size = ldmaCtrlSizeWord;
+  stream->descriptors[1].xfer.size = ldmaCtrlSizeWord;
+
+  stream->buffer = (uint32_t *)buffer;
+  stream->half_len = descriptor_len;
+  stream->user_refill_callback = user_refill_callback;
+  stream->active = true;
+
+  LDMA_TransferCfg_t transfer_cfg = LDMA_TRANSFER_CFG_PERIPHERAL(timer_overflow_signal);
+  DMADRV_LdmaStartTransfer((int)stream->dma_channel,
+                           &transfer_cfg,
+                           &stream->descriptors[0],
+                           ping_pong ? stream_dma_transfer_finished_cb : NULL,
+                           this);
+  return SL_STATUS_OK;
+}
+
+sl_status_t DacClass::start_stream_timer(uint32_t sample_rate_hz)
+{
+  CMU_Clock_TypeDef timer_clock;
+  if (sample_rate_hz > this->max_stream_sample_rate_hz
+      || !TimerAllocatorClass::get_clock(this->stream_timer, &timer_clock)) {
+    return SL_STATUS_INVALID_RANGE;
+  }
+  // The timer may be used by the PWM or other peripherals
+  if (!TimerAllocator.claim(this->stream_timer)) {
+    return SL_STATUS_BUSY;
+  }
+
+  CMU_ClockEnable(timer_clock, true);
+  uint32_t timer_freq = CMU_ClockFreqGet(timer_clock);
+  // Round to the nearest achievable rate
+  uint32_t timer_cycles = (timer_freq + (sample_rate_hz / 2u)) / sample_rate_hz;
+
+  // Prescale the timer clock if the period doesn't fit into the counter
+  uint32_t prescale = (timer_cycles / TIMER_MaxCount(this->stream_timer)) + 1u;
+  if (prescale > this->max_stream_timer_prescale) {
+    TimerAllocator.release(this->stream_timer);
+    return SL_STATUS_INVALID_RANGE;
+  }
+  timer_cycles = timer_cycles / prescale;
+
+  TIMER_Init_TypeDef timer_init = TIMER_INIT_DEFAULT;
+  timer_init.enable = false;
+  timer_init.prescale = (TIMER_Prescale_TypeDef)(prescale - 1u);
+  // Clear the overflow DMA request when the LDMA picks it up - it doesn't access the timer
+  timer_init.dmaClrAct = true;
+  TIMER_Init(this->stream_timer, &timer_init);
+  TIMER_TopSet(this->stream_timer, timer_cycles - 1u);
+  TIMER_Enable(this->stream_timer, true);
+
+  this->stream_sample_rate_hz = sample_rate_hz;
+  this->stream_timer_freq = timer_freq / prescale;
+  this->stream_timer_cycles = timer_cycles;
+  return SL_STATUS_OK;
+}
+
+void DacClass::stream_stop(uint8_t channel_num)
+{
+  if (!this->is_streaming(channel_num)) {
+    return;
+  }
+
+  dac_stream_t *stream = &this->streams[channel_num];
+  DMADRV_StopTransfer(stream->dma_channel);
+  DMADRV_FreeChannel(stream->dma_channel);
+  stream->active = false;
+  stream->user_refill_callback = nullptr;
+
+  // Stop the timer when the last stream ends
+  if (!this->is_streaming(1u - channel_num)) {
+    TIMER_Enable(this->stream_timer, false);
+    TimerAllocator.release(this->stream_timer);
+    this->stream_sample_rate_hz = 0u;
+    this->stream_timer_cycles = 0u;
+    #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
+    // Remove the energy mode requirement
+    sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
+    #endif // SL_CATALOG_POWER_MANAGER_PRESENT
+  }
+}
+
+bool DacClass::is_streaming(uint8_t channel_num)
+{
+  if (channel_num > 1) {
+    return false;
+  }
+  return this->streams[channel_num].active;
+}
+
+float DacClass::get_stream_sample_rate()
+{
+  if (this->stream_timer_cycles == 0u) {
+    return 0.0f;
+  }
+  return (float)this->stream_timer_freq / (float)this->stream_timer_cycles;
+}
+
+sl_status_t DacClass::connect_stream_timer_prs(unsigned int prs_channel)
+{
+  PRS_Signal_t timer_prs_signal;
+  if (prs_channel >= PRS_ASYNC_CH_NUM) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  if (!get_timer_overflow_prs_signal(this->stream_timer, &timer_prs_signal)) {
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+
+  CMU_ClockEnable(cmuClock_PRS, true);
+  PRS_ConnectSignal(prs_channel, prsTypeAsync, timer_prs_signal);
+  return SL_STATUS_OK;
+}
+
+void DacClass::handle_stream_dma_callback(unsigned int dma_channel, unsigned int sequence_no)
+{
+  for (auto& stream : this->streams) {
+    if (!stream.active || stream.dma_channel != dma_channel || !stream.user_refill_callback) {
+      continue;
+    }
+    // The halves finish alternately starting with the first one
+    uint32_t *played_half = stream.buffer + (((sequence_no - 1u) % 2u) * stream.half_len);
+    stream.user_refill_callback(played_half, stream.half_len);
+  }
+}
+
+// The PRS lookup lives here as the timer allocator is shared with devices without PRS headers
+static bool get_timer_overflow_prs_signal(TIMER_TypeDef* timer, PRS_Signal_t* signal)
+{
+  #if defined(TIMER0)
+  if (timer == TIMER0) {
+    *signal = prsSignalTIMER0_OF;
+    return true;
+  }
+  #endif // TIMER0
+  #if defined(TIMER1)
+  if (timer == TIMER1) {
+    *signal = prsSignalTIMER1_OF;
+    return true;
+  }
+  #endif // TIMER1
+  #if defined(TIMER2)
+  if (timer == TIMER2) {
+    *signal = prsSignalTIMER2_OF;
+    return true;
+  }
+  #endif // TIMER2
+  #if defined(TIMER3)
+  if (timer == TIMER3) {
+    *signal = prsSignalTIMER3_OF;
+    return true;
+  }
+  #endif // TIMER3
+  #if defined(TIMER4)
+  if (timer == TIMER4) {
+    *signal = prsSignalTIMER4_OF;
+    return true;
+  }
+  #endif // TIMER4
+  return false;
+}
+
+static bool stream_dma_transfer_finished_cb(unsigned int channel, unsigned int sequenceNo, void *userParam)
+{
+  DacClass *dac = (DacClass *)userParam;
+  dac->handle_stream_dma_callback(channel, sequenceNo);
+  return false;
 }
 
+// The streams of each DAC are paced by their own timer - the PWM allocates the timers from TIMER0 upwards
 #if (NUM_DAC_HW > 0)
-arduino::DacClass DAC_0(VDAC0, SL_DAC0_CH0_PIN, SL_DAC0_CH1_PIN);
+arduino::DacClass DAC_0(VDAC0, SL_DAC0_CH0_PIN, SL_DAC0_CH1_PIN, TIMER3);
 #endif
 
 #if (NUM_DAC_HW > 1)
-arduino::DacClass DAC_1(VDAC1, SL_DAC1_CH0_PIN, SL_DAC1_CH1_PIN);
+arduino::DacClass DAC_1(VDAC1, SL_DAC1_CH0_PIN, SL_DAC1_CH1_PIN, TIMER4);
 #endif
 
 #endif // NUM_DAC_HW
@@ -32,7 +32,13 @@
 #ifdef NUM_DAC_HW
 
 #include "em_cmu.h"
+#include "em_ldma.h"
+#include "em_prs.h"
+#include "em_timer.h"
 #include "em_vdac.h"
+#include "dmadrv.h"
+#include "sl_status.h"
+#include "timer_allocator.h"
 
 enum dac_voltage_ref_t {
   DAC_VREF_1V25 = 0,          // 1.25V
@@ -52,8 +58,9 @@ public:
    * @param[in] vdac_peripheral The DAC peripheral to be used
    * @param[in] ch0_pin The output pin for channel 0
    * @param[in] ch1_pin The output pin for channel 1
+   * @param[in] stream_timer The timer pacing the streamed samples
    ******************************************************************************/
-  DacClass(VDAC_TypeDef* vdac_peripheral, PinName ch0_pin, PinName ch1_pin);
+  DacClass(VDAC_TypeDef* vdac_peripheral, PinName ch0_pin, PinName ch1_pin, TIMER_TypeDef* stream_timer);
 
   /***************************************************************************//**
    * Sets the specified DAC channel's output to the desired value
@@ -63,6 +70,19 @@ public:
    ******************************************************************************/
   void set_output(uint8_t channel_num, uint32_t value);
 
+  /***************************************************************************//**
+   * Sets the output of both DAC channels with back-to-back writes
+   *
+   * Both channels are enabled and their new values are written right after each
+   * other with the interrupts disabled, so the outputs change within a few bus
+   * cycles - they're not synchronized to the same DAC clock cycle.
+   * A 0 value doesn't deinitialize the channels here.
+   *
+   * @param[in] ch0_value the value to set channel 0 to
+   * @param[in] ch1_value the value to set channel 1 to
+   ******************************************************************************/
+  void set_outputs(uint32_t ch0_value, uint32_t ch1_value);
+
   /***************************************************************************//**
    * Initializes the DAC hardware and the requested channel
    *
@@ -72,6 +92,7 @@ public:
 
   /***************************************************************************//**
    * Deintializes the requested DAC channel
+   * The other channel keeps its output undisturbed.
    *
    * @param[in] channel_num the DAC channel to be deinitialized
    ******************************************************************************/
@@ -79,9 +100,8 @@ public:
 
   /***************************************************************************//**
    * Sets whether the DAC channels should automatically deinitialize
-   * when a 0 value is written to it. When deinitializing a channel and an
-   * other channel is still active - the active channel will also
-   * deinitialize momentarily. This is on by default, but it can
+   * when a 0 value is written to it. The output of a deinitialized channel
+   * is disabled instead of being driven to 0V. This is on by default, but it can
    * interfere with certain applications, so it can be turned off.
    * Once turned off the user is responsible for deinitializing the DAC and it's
    * channels by calling deinit().
@@ -106,17 +126,158 @@ public:
    *  - DAC_VREF_AVDD,
    *  - DAC_VREF_EXTERNAL_PIN
    *
+   * The reference can only be changed while the VDAC is disabled, the enabled
+   * channels are restored with their last values right after the change.
+   * The change resets the VDAC with VDAC_Reset(), so both outputs glitch
+   * while the peripheral is reinitialized.
+   *
    * @param[in] reference The selected reference from 'dac_voltage_references'
    ******************************************************************************/
   void set_voltage_reference(dac_voltage_ref_t reference);
 
+  /***************************************************************************//**
+   * Streams samples from a ping-pong buffer to a DAC channel using DMA
+   *
+   * The samples are written to the channel by the LDMA on every overflow of a
+   * hardware timer, so the output rate doesn't depend on the CPU at all.
+   * The buffer is played in two halves - when one half has been played the
+   * callback is called with it to be refilled while the other half is playing.
+   * Fill the whole buffer before starting the stream.
+   * The samples are 12-bit values (0 - 4095) regardless of the write resolution.
+   * Both channels of the DAC share the timer, so they stream at the same rate.
+   * The timer is claimed from 'TimerAllocator' while streaming - SL_STATUS_BUSY
+   * is returned if it's used by something else (e.g. PWM on many frequencies).
+   * The callback is called from interrupt context.
+   *
+   * @param[in] channel_num The DAC channel to stream to
+   * @param[in] buffer The sample buffer
+   * @param[in] len The number of samples in the buffer - must be even
+   * @param[in] sample_rate_hz The requested output rate in Hz
+   * @param[in] user_refill_callback Called with the half of the buffer which has been played
+   *
+   * @return Status of the stream start process
+   ******************************************************************************/
+  sl_status_t stream(uint8_t channel_num, uint32_t *buffer, uint32_t len, uint32_t sample_rate_hz, void (*user_refill_callback)(uint32_t *half_buffer, uint32_t half_len));
+
+  /***************************************************************************//**
+   * Plays a table of samples on a DAC channel in an endless loop using DMA
+   *
+   * The LDMA descriptor links to itself, so periodic waveforms are generated
+   * without any CPU involvement or interrupts once started.
+   * The samples are 12-bit values (0 - 4095) regardless of the write resolution.
+   *
+   * @param[in] channel_num The DAC channel to stream to
+   * @param[in] table The samples of one period of the waveform - it can be in flash
+   * @param[in] len The number of samples in the table
+   * @param[in] sample_rate_hz The requested output rate in Hz
+   *
+   * @return Status of the stream start process
+   ******************************************************************************/
+  sl_status_t stream(uint8_t channel_num, const uint32_t *table, uint32_t len, uint32_t sample_rate_hz);
+
+  /***************************************************************************//**
+   * Stops streaming to a DAC channel - the output keeps the last sample
+   *
+   * @param[in] channel_num The DAC channel to stop
+   ******************************************************************************/
+  void stream_stop(uint8_t channel_num);
+
+  /***************************************************************************//**
+   * Returns the sample rate achieved by the streaming timer
+   *
+   * @return the stream sample rate in Hz, 0 if nothing is streaming
+   ******************************************************************************/
+  float get_stream_sample_rate();
+
+  /***************************************************************************//**
+   * Outputs the overflows of the stream timer on a PRS channel
+   *
+   * Other peripherals can be triggered by it to work in lockstep with the streams,
+   * e.g. the ADC can sample right when the next sample is written to the DAC.
+   *
+   * @param[in] prs_channel The asynchronous PRS channel to drive
+   *
+   * @return Status of the PRS connect process
+   ******************************************************************************/
+  sl_status_t connect_stream_timer_prs(unsigned int prs_channel);
+
+  /***************************************************************************//**
+   * Callback handler for the stream DMA transfers
+   *
+   * @param[in] dma_channel The LDMA channel which finished a descriptor
+   * @param[in] sequence_no The number of finished descriptors on the channel
+   ******************************************************************************/
+  void handle_stream_dma_callback(unsigned int dma_channel, unsigned int sequence_no);
+
 private:
   /***************************************************************************//**
-   * Initializes a specific channel of the DAC hardware
+   * Initializes the DAC hardware and configures both of its channels
+   ******************************************************************************/
+  void init_peripheral();
+
+  /***************************************************************************//**
+   * Configures a specific channel of the DAC hardware without enabling it
    *
-   * @param[in] channel_num the DAC channel to be deinitialized
+   * @param[in] channel_num the DAC channel to be configured
+   ******************************************************************************/
+  void configure_channel(uint8_t channel_num);
+
+  /***************************************************************************//**
+   * Enables a specific channel of the already initialized DAC hardware
+   *
+   * @param[in] channel_num the DAC channel to be enabled
+   ******************************************************************************/
+  void enable_channel(uint8_t channel_num);
+
+  /***************************************************************************//**
+   * Maps a value from the current write resolution to the true DAC resolution
+   *
+   * @param[in] value the value in the current write resolution
+   *
+   * @return the value in 12 bits
    ******************************************************************************/
-  void init_channel(uint8_t channel_num);
+  uint32_t map_to_true_resolution(uint32_t value);
+
+  /***************************************************************************//**
+   * Starts streaming to a DAC channel
+   *
+   * @param[in] channel_num The DAC channel to stream to
+   * @param[in] buffer The sample buffer
+   * @param[in] len The number of samples in the buffer
+   * @param[in] sample_rate_hz The requested output rate in Hz
+   * @param[in] user_refill_callback Refill callback for ping-pong mode - nullptr to loop the buffer
+   *
+   * @return Status of the stream start process
+   ******************************************************************************/
+  sl_status_t start_stream(uint8_t channel_num, const uint32_t *buffer, uint32_t len, uint32_t sample_rate_hz, void (*user_refill_callback)(uint32_t *half_buffer, uint32_t half_len));
+
+  /***************************************************************************//**
+   * Starts the timer pacing the streams
+   *
+   * @param[in] sample_rate_hz The requested output rate in Hz
+   *
+   * @return Status of the timer start process
+   ******************************************************************************/
+  sl_status_t start_stream_timer(uint32_t sample_rate_hz);
+
+  /***************************************************************************//**
+   * Checks whether a DAC channel is streaming
+   *
+   * @param[in] channel_num The DAC channel to check
+   *
+   * @return true if the channel is streaming
+   ******************************************************************************/
+  bool is_streaming(uint8_t channel_num);
+
+  // State of the DMA stream of a DAC channel
+  typedef struct {
+    bool active;
+    unsigned int dma_channel;
+    uint32_t *buffer;
+    uint32_t half_len;
+    void (*user_refill_callback)(uint32_t *half_buffer, uint32_t half_len);
+    LDMA_Descriptor_t descriptors[2];
+  } dac_stream_t;
 
   bool dac_initialized;
   PinName ch0_pin;
@@ -130,12 +291,21 @@ private:
   VDAC_TypeDef* vdac_peripheral;
   uint32_t dac_max_value;
   VDAC_Ref_TypeDef voltage_ref;
+  TIMER_TypeDef* stream_timer;
+  uint32_t stream_sample_rate_hz;
+  uint32_t stream_timer_freq;
+  uint32_t stream_timer_cycles;
+  dac_stream_t streams[2];
 
   // VDAC to max frequency (1 MHz)
   static const uint32_t vdac_max_freq = 1000000u;
   // The DAC has a 12 bit resolution - the max accepted value is 4095
   static const uint8_t dac_true_bit_resolution = 12u;
   static const uint32_t dac_true_max_value = 4095u;
+  // The maximum conversion rate of the DAC
+  static const uint32_t max_stream_sample_rate_hz = 500000u;
+  // The largest prescaler of the stream timer clock
+  static const uint32_t max_stream_timer_prescale = 1024u;
 };
 } // namespace arduino
 
@@ -0,0 +1,315 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "freq_meter.h"
+
+using namespace arduino;
+
+FreqMeter::FreqMeter() :
+  running(false),
+  pin(PIN_NAME_NC),
+  timer(nullptr),
+  clock(cmuClock_TIMER0),
+  tick_frequency(0.0f),
+  capture_pulse_width(false),
+  period_dma_channel(0u),
+  pulse_width_dma_channel(0u),
+  period_descriptor(),
+  pulse_width_descriptor(),
+  period_ring(),
+  pulse_width_ring()
+{
+  ;
+}
+
+FreqMeter::~FreqMeter()
+{
+  this->end();
+}
+
+sl_status_t FreqMeter::begin(PinName pin, float min_frequency_hz)
+{
+  return this->start(pin, min_frequency_hz, false);
+}
+
+sl_status_t FreqMeter::begin(pin_size_t pin, float min_frequency_hz)
+{
+  return this->begin(pinToPinName(pin), min_frequency_hz);
+}
+
+sl_status_t FreqMeter::start(PinName pin, float min_frequency_hz, bool capture_pulse_width)
+{
+  if (pin == PIN_NAME_NC || pin >= PIN_NAME_MAX || !(min_frequency_hz > 0.0f)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  // Stop the previous measurement
+  this->end();
+
+  TIMER_TypeDef *timer = TimerAllocator.allocate();
+  if (timer == nullptr) {
+    return SL_STATUS_NO_MORE_RESOURCE;
+  }
+  CMU_Clock_TypeDef clock;
+  if (!TimerAllocator.get_clock(timer, &clock)) {
+    TimerAllocator.release(timer);
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+
+  // Choose the smallest prescaler which lets the counter cover the period of the lowest frequency
+  CMU_ClockEnable(clock, true);
+  float clock_freq = (float)CMU_ClockFreqGet(clock);
+  float min_prescale = clock_freq / (min_frequency_hz * ((float)TIMER_MaxCount(timer) + 1.0f));
+  uint32_t prescale = (min_prescale <= 1.0f) ? 1u : (uint32_t)ceilf(min_prescale);
+  if (prescale > 1024u) {
+    CMU_ClockEnable(clock, false);
+    TimerAllocator.release(timer);
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  this->timer = timer;
+  this->clock = clock;
+  this->pin = pin;
+  this->tick_frequency = clock_freq / (float)prescale;
+  this->capture_pulse_width = capture_pulse_width;
+  for (uint8_t i = 0u; i < ring_size; i++) {
+    this->period_ring[i] = 0u;
+    this->pulse_width_ring[i] = 0u;
+  }
+
+  // Every rising edge captures the counter and restarts it from zero - the capture is the period
+  // The counter stops when it overflows, which tells that the signal is gone
+  TIMER_Init_TypeDef timer_init = TIMER_INIT_DEFAULT;
+  timer_init.enable = false;
+  timer_init.prescale = (TIMER_Prescale_TypeDef)(prescale - 1u);
+  timer_init.riseAction = timerInputActionReloadStart;
+  timer_init.oneShot = true;
+  TIMER_Init(timer, &timer_init);
+
+  TIMER_InitCC_TypeDef cc_init = TIMER_INITCC_DEFAULT;
+  cc_init.mode = timerCCModeCapture;
+  cc_init.eventCtrl = timerEventEveryEdge;
+  cc_init.edge = timerEdgeRising;
+  TIMER_InitCC(timer, this->period_cc_channel, &cc_init);
+  // The falling edges capture the time since the last rising edge - the pulse width
+  if (capture_pulse_width) {
+    cc_init.edge = timerEdgeFalling;
+    TIMER_InitCC(timer, this->pulse_width_cc_channel, &cc_init);
+  }
+  TIMER_TopSet(timer, TIMER_MaxCount(timer));
+
+  // Route the pin to the capture inputs - inputs don't have to be enabled in ROUTEEN
+  GPIO_Port_TypeDef port = getSilabsPortFromArduinoPin(pin);
+  uint32_t gpio_pin = getSilabsPinFromArduinoPin(pin);
+  GPIO_PinModeSet(port, gpio_pin, gpioModeInput, 0);
+  uint32_t route = ((uint32_t)port << _GPIO_TIMER_CC0ROUTE_PORT_SHIFT) | (gpio_pin << _GPIO_TIMER_CC0ROUTE_PIN_SHIFT);
+  volatile uint32_t *cc_routes = &GPIO->TIMERROUTE[TIMER_NUM(timer)].CC0ROUTE;
+  cc_routes[this->period_cc_channel] = route;
+  if (capture_pulse_width) {
+    cc_routes[this->pulse_width_cc_channel] = route;
+  }
+
+  // Initialize DMA with default parameters
+  DMADRV_Init();
+  sl_status_t status = this->start_capture_dma(this->period_cc_channel, this->period_ring, &this->period_descriptor, &this->period_dma_channel);
+  if (status == SL_STATUS_OK && capture_pulse_width) {
+    status = this->start_capture_dma(this->pulse_width_cc_channel, this->pulse_width_ring, &this->pulse_width_descriptor, &this->pulse_width_dma_channel);
+    if (status != SL_STATUS_OK) {
+      DMADRV_StopTransfer(this->period_dma_channel);
+      DMADRV_FreeChannel(this->period_dma_channel);
+    }
+  }
+  if (status != SL_STATUS_OK) {
+    cc_routes[this->period_cc_channel] = 0u;
+    cc_routes[this->pulse_width_cc_channel] = 0u;
+    GPIO_PinModeSet(port, gpio_pin, gpioModeDisabled, 0);
+    TIMER_Reset(timer);
+    CMU_ClockEnable(clock, false);
+    TimerAllocator.release(timer);
+    this->timer = nullptr;
+    return status;
+  }
+
+  #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
+  // Require at least EM1 to keep the timer peripheral running
+  sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
+  #endif // SL_CATALOG_POWER_MANAGER_PRESENT
+
+  this->running = true;
+  return SL_STATUS_OK;
+}
+
+sl_status_t FreqMeter::start_capture_dma(uint8_t cc_channel, volatile uint32_t *ring, LDMA_Descriptor_t *descriptor, unsigned int *dma_channel)
+{
+  LDMA_PeripheralSignal_t capture_signal;
+  if (!TimerAllocator.get_cc_dma_signal(this->timer, cc_channel, &capture_signal)) {
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+  if (DMADRV_AllocateChannel(dma_channel, NULL) != ECODE_EMDRV_DMADRV_OK) {
+    return SL_STATUS_NO_MORE_RESOURCE;
+  }
+
+  // Reading the capture FIFO clears the request - the descriptor links to itself,
+  // so the captures go around the ring endlessly without any interrupts
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+  *descriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(&this->timer->CC[cc_channel].ICF, ring, ring_size, 0);
+  #pragma GCC diagnostic pop
+  descriptor->xfer.size = ldmaCtrlSizeWord;
+  descriptor->xfer.doneIfs = 0u;
+
+  LDMA_TransferCfg_t transfer_cfg = LDMA_TRANSFER_CFG_PERIPHERAL(capture_signal);
+  DMADRV_LdmaStartTransfer((int)*dma_channel, &transfer_cfg, descriptor, NULL, NULL);
+  return SL_STATUS_OK;
+}
+
+void FreqMeter::end()
+{
+  if (!this->running) {
+    return;
+  }
+
+  DMADRV_StopTransfer(this->period_dma_channel);
+  DMADRV_FreeChannel(this->period_dma_channel);
+  if (this->capture_pulse_width) {
+    DMADRV_StopTransfer(this->pulse_width_dma_channel);
+    DMADRV_FreeChannel(this->pulse_width_dma_channel);
+  }
+
+  volatile uint32_t *cc_routes = &GPIO->TIMERROUTE[TIMER_NUM(this->timer)].CC0ROUTE;
+  cc_routes[this->period_cc_channel] = 0u;
+  cc_routes[this->pulse_width_cc_channel] = 0u;
+  GPIO_PinModeSet(getSilabsPortFromArduinoPin(this->pin), getSilabsPinFromArduinoPin(this->pin), gpioModeDisabled, 0);
+
+  TIMER_Reset(this->timer);
+  CMU_ClockEnable(this->clock, false);
+  TimerAllocator.release(this->timer);
+
+  #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
+  sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
+  #endif // SL_CATALOG_POWER_MANAGER_PRESENT
+
+  this->timer = nullptr;
+  this->pin = PIN_NAME_NC;
+  this->running = false;
+}
+
+bool FreqMeter::is_signal_present()
+{
+  if (!this->running) {
+    return false;
+  }
+  if (this->timer->STATUS & TIMER_STATUS_RUNNING) {
+    return true;
+  }
+
+  // The counter is stopped before the first edge and after an overflow
+  for (uint8_t i = 0u; i < ring_size; i++) {
+    this->period_ring[i] = 0u;
+    this->pulse_width_ring[i] = 0u;
+  }
+  return false;
+}
+
+float FreqMeter::get_average_ticks(const volatile uint32_t *ring)
+{
+  // Zero is the value captured by the edge starting the counter - it's not a valid measurement
+  uint64_t sum = 0u;
+  uint32_t count = 0u;
+  for (uint8_t i = 0u; i < ring_size; i++) {
+    uint32_t ticks = ring[i];
+    if (ticks != 0u) {
+      sum += ticks;
+      count++;
+    }
+  }
+  if (count == 0u) {
+    return 0.0f;
+  }
+  return (float)sum / (float)count;
+}
+
+float FreqMeter::get_frequency()
+{
+  if (!this->is_signal_present()) {
+    return 0.0f;
+  }
+  float period_ticks = this->get_average_ticks(this->period_ring);
+  if (period_ticks == 0.0f) {
+    return 0.0f;
+  }
+  return this->tick_frequency / period_ticks;
+}
+
+float FreqMeter::get_period_us()
+{
+  if (!this->is_signal_present()) {
+    return 0.0f;
+  }
+  return this->get_average_ticks(this->period_ring) * 1000000.0f / this->tick_frequency;
+}
+
+bool FreqMeter::is_running()
+{
+  return this->running;
+}
+
+sl_status_t PwmIn::begin(PinName pin, float min_frequency_hz)
+{
+  return this->start(pin, min_frequency_hz, true);
+}
+
+sl_status_t PwmIn::begin(pin_size_t pin, float min_frequency_hz)
+{
+  return this->begin(pinToPinName(pin), min_frequency_hz);
+}
+
+float PwmIn::get_duty_cycle()
+{
+  if (!this->running) {
+    return 0.0f;
+  }
+  // Without edges the signal is a constant level
+  if (!this->is_signal_present()) {
+    return GPIO_PinInGet(getSilabsPortFromArduinoPin(this->pin), getSilabsPinFromArduinoPin(this->pin)) ? 100.0f : 0.0f;
+  }
+
+  float period_ticks = this->get_average_ticks(this->period_ring);
+  float pulse_width_ticks = this->get_average_ticks(this->pulse_width_ring);
+  if (period_ticks == 0.0f) {
+    return 0.0f;
+  }
+  float duty_cycle = pulse_width_ticks * 100.0f / period_ticks;
+  return (duty_cycle > 100.0f) ? 100.0f : duty_cycle;
+}
+
+float PwmIn::get_pulse_width_us()
+{
+  if (!this->is_signal_present()) {
+    return 0.0f;
+  }
+  return this->get_average_ticks(this->pulse_width_ring) * 1000000.0f / this->tick_frequency;
+}
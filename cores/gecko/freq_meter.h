@@ -0,0 +1,202 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Arduino.h"
+
+#ifndef __ARDUINO_FREQ_METER_H
+#define __ARDUINO_FREQ_METER_H
+
+#include <cmath>
+#include <inttypes.h>
+#include "pinDefinitions.h"
+#include "em_cmu.h"
+#include "em_gpio.h"
+#include "em_ldma.h"
+#include "em_timer.h"
+#include "dmadrv.h"
+#include "sl_status.h"
+#include "timer_allocator.h"
+
+#if defined(SL_CATALOG_POWER_MANAGER_PRESENT)
+  #include "sl_power_manager.h"
+#endif
+
+namespace arduino {
+class FreqMeter {
+public:
+  /***************************************************************************//**
+   * Constructor for FreqMeter
+   ******************************************************************************/
+  FreqMeter();
+
+  /***************************************************************************//**
+   * Destructor for FreqMeter - stops the measurement
+   ******************************************************************************/
+  ~FreqMeter();
+
+  /***************************************************************************//**
+   * Starts measuring the frequency of a signal on a pin
+   *
+   * Every rising edge captures the elapsed time since the previous one in a
+   * hardware timer and restarts it. The LDMA moves the captured periods into a
+   * small ring buffer, so there's no CPU cost per edge - the results are only
+   * calculated when they're requested.
+   * The measurement uses a free TIMER peripheral and keeps the device in EM1.
+   *
+   * @param[in] pin The input pin
+   * @param[in] min_frequency_hz The lowest frequency to measure - it sets the
+   *            timer prescaler, so a higher value gives a better resolution
+   *
+   * @return Status of the start process
+   ******************************************************************************/
+  sl_status_t begin(PinName pin, float min_frequency_hz = 1.0f);
+  sl_status_t begin(pin_size_t pin, float min_frequency_hz = 1.0f);
+
+  /***************************************************************************//**
+   * Stops the measurement and releases the timer
+   ******************************************************************************/
+  void end();
+
+  /***************************************************************************//**
+   * Returns the frequency averaged over the last captured periods
+   *
+   * @return the frequency in Hz - 0 if there was no edge within the period
+   *         of the lowest measured frequency
+   ******************************************************************************/
+  float get_frequency();
+
+  /***************************************************************************//**
+   * Returns the period averaged over the last captured periods
+   *
+   * @return the period in microseconds - 0 if there's no signal
+   ******************************************************************************/
+  float get_period_us();
+
+  /***************************************************************************//**
+   * Returns whether the measurement is running
+   *
+   * @return true if the measurement is running
+   ******************************************************************************/
+  bool is_running();
+
+  // The number of captures kept and averaged
+  static const uint8_t ring_size = 8u;
+
+protected:
+  /***************************************************************************//**
+   * Sets up the timer and the LDMA channels for the measurement
+   *
+   * @param[in] pin The input pin
+   * @param[in] min_frequency_hz The lowest frequency to measure
+   * @param[in] capture_pulse_width Also capture the time of the falling edges
+   *
+   * @return Status of the start process
+   ******************************************************************************/
+  sl_status_t start(PinName pin, float min_frequency_hz, bool capture_pulse_width);
+
+  /***************************************************************************//**
+   * Starts looping the captures of a timer channel into a ring buffer
+   *
+   * @param[in] cc_channel The capture channel of the timer
+   * @param[in] ring The ring buffer
+   * @param[in] descriptor The self-linked descriptor of the transfer
+   * @param[out] dma_channel The allocated LDMA channel
+   *
+   * @return Status of the transfer start
+   ******************************************************************************/
+  sl_status_t start_capture_dma(uint8_t cc_channel, volatile uint32_t *ring, LDMA_Descriptor_t *descriptor, unsigned int *dma_channel);
+
+  /***************************************************************************//**
+   * Returns the average of the valid captures in a ring buffer
+   *
+   * @param[in] ring The ring buffer
+   *
+   * @return the average in timer ticks - 0 if there are no valid captures
+   ******************************************************************************/
+  float get_average_ticks(const volatile uint32_t *ring);
+
+  /***************************************************************************//**
+   * Returns whether an edge arrived within the measurement range
+   * The ring buffers are cleared if the signal stopped, so old captures don't
+   * distort the results when it comes back.
+   *
+   * @return true if the signal is present
+   ******************************************************************************/
+  bool is_signal_present();
+
+  bool running;
+  PinName pin;
+  TIMER_TypeDef *timer;
+  CMU_Clock_TypeDef clock;
+  // The frequency the timer counts with
+  float tick_frequency;
+  bool capture_pulse_width;
+  unsigned int period_dma_channel;
+  unsigned int pulse_width_dma_channel;
+  LDMA_Descriptor_t period_descriptor;
+  LDMA_Descriptor_t pulse_width_descriptor;
+  // The LDMA writes the captured timer values here
+  volatile uint32_t period_ring[ring_size];
+  volatile uint32_t pulse_width_ring[ring_size];
+
+  static const uint8_t period_cc_channel = 0u;
+  static const uint8_t pulse_width_cc_channel = 1u;
+};
+
+class PwmIn : public FreqMeter {
+public:
+  /***************************************************************************//**
+   * Starts measuring the frequency and duty cycle of a signal on a pin
+   *
+   * On top of the period capture the falling edges capture the pulse width
+   * on a second channel of the same timer.
+   *
+   * @param[in] pin The input pin
+   * @param[in] min_frequency_hz The lowest frequency to measure
+   *
+   * @return Status of the start process
+   ******************************************************************************/
+  sl_status_t begin(PinName pin, float min_frequency_hz = 1.0f);
+  sl_status_t begin(pin_size_t pin, float min_frequency_hz = 1.0f);
+
+  /***************************************************************************//**
+   * Returns the duty cycle averaged over the last captured periods
+   *
+   * @return the duty cycle in percent - 0 or 100 depending on the level of
+   *         the pin if there's no signal
+   ******************************************************************************/
+  float get_duty_cycle();
+
+  /***************************************************************************//**
+   * Returns the high time averaged over the last captured periods
+   *
+   * @return the pulse width in microseconds - 0 if there's no signal
+   ******************************************************************************/
+  float get_pulse_width_us();
+};
+} // namespace arduino
+
+#endif // __ARDUINO_FREQ_METER_H
@@ -0,0 +1,339 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "pcnt.h"
+
+#if defined(PCNT_PRESENT)
+
+using namespace arduino;
+
+PulseCounterClass::PulseCounterClass() :
+  running(false),
+  em1_required(false),
+  mode(PCNT_CFG_MODE_EXTCLKSINGLE),
+  s0_pin(PIN_NAME_NC),
+  s1_pin(PIN_NAME_NC),
+  top(UINT16_MAX),
+  pending_top(UINT16_MAX),
+  top_pending(false),
+  wrapped_count(0u),
+  reset_base(0u),
+  quadrature_error_count(0u),
+  user_overflow_callback(nullptr),
+  user_underflow_callback(nullptr)
+{
+  ;
+}
+
+sl_status_t PulseCounterClass::begin(PinName pin, PinStatus edge)
+{
+  if (pin == PIN_NAME_NC) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  // The external clock mode counts one edge of the S0 input
+  uint32_t ctrl;
+  if (edge == RISING) {
+    ctrl = 0u;
+  } else if (edge == FALLING) {
+    ctrl = PCNT_CTRL_EDGE;
+  } else {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  return this->start(pin, PIN_NAME_NC, PCNT_CFG_MODE_EXTCLKSINGLE, ctrl);
+}
+
+sl_status_t PulseCounterClass::begin(pin_size_t pin, PinStatus edge)
+{
+  return this->begin(pinToPinName(pin), edge);
+}
+
+sl_status_t PulseCounterClass::begin_quadrature(PinName pin_a, PinName pin_b, uint8_t resolution)
+{
+  if (pin_a == PIN_NAME_NC || pin_b == PIN_NAME_NC || pin_a == pin_b) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  uint32_t mode;
+  switch (resolution) {
+    case 1u:
+      mode = PCNT_CFG_MODE_EXTCLKQUAD;
+      break;
+    case 2u:
+      mode = PCNT_CFG_MODE_OVSQUAD2X;
+      break;
+    case 4u:
+      mode = PCNT_CFG_MODE_OVSQUAD4X;
+      break;
+    default:
+      return SL_STATUS_INVALID_PARAMETER;
+  }
+  return this->start(pin_a, pin_b, mode, 0u);
+}
+
+sl_status_t PulseCounterClass::begin_quadrature(pin_size_t pin_a, pin_size_t pin_b, uint8_t resolution)
+{
+  return this->begin_quadrature(pinToPinName(pin_a), pinToPinName(pin_b), resolution);
+}
+
+sl_status_t PulseCounterClass::start(PinName s0_pin, PinName s1_pin, uint32_t mode, uint32_t ctrl)
+{
+  // Stop the previous counting
+  this->end();
+
+  this->mode = mode;
+  this->s0_pin = s0_pin;
+  this->s1_pin = s1_pin;
+  if (this->top_pending) {
+    this->top = this->pending_top;
+    this->top_pending = false;
+  }
+  this->wrapped_count = 0u;
+  this->reset_base = 0u;
+  this->quadrature_error_count = 0u;
+
+  CMU_ClockEnable(cmuClock_PCNT0, true);
+  // The clock source can only be changed while the PCNT is disabled
+  CMU_ClockSelectSet(cmuClock_PCNT0CLK, this->is_externally_clocked() ? cmuSelect_PCNTEXTCLK : cmuSelect_EM23GRPACLK);
+
+  this->route_pin(s0_pin, &GPIO->PCNTROUTE[0].S0INROUTE);
+  if (s1_pin != PIN_NAME_NC) {
+    this->route_pin(s1_pin, &GPIO->PCNTROUTE[0].S1INROUTE);
+  }
+
+  // The configuration is only writable while the PCNT is disabled
+  // The digital filter only works with the oversampling modes
+  PCNT0->CFG = mode | (this->is_externally_clocked() ? 0u : PCNT_CFG_FILTEN);
+  PCNT0->EN_SET = PCNT_EN_EN;
+
+  // With an external clock the writes are synchronized by the first input edges,
+  // with the oversampling modes the low frequency clock synchronizes them right away
+  PCNT0->CTRL = ctrl;
+  PCNT0->TOP = this->top;
+  PCNT0->CMD = PCNT_CMD_STARTCNT;
+  if (!this->is_externally_clocked()) {
+    while (PCNT0->SYNCBUSY & (PCNT_SYNCBUSY_CTRL | PCNT_SYNCBUSY_TOP | PCNT_SYNCBUSY_CMD)) ;
+  }
+
+  PCNT0->IF_CLR = _PCNT_IF_MASK;
+  PCNT0->IEN = PCNT_IEN_OF | PCNT_IEN_UF | (this->is_externally_clocked() ? 0u : PCNT_IEN_OQSTERR);
+  NVIC_ClearPendingIRQ(PCNT0_IRQn);
+  NVIC_EnableIRQ(PCNT0_IRQn);
+
+#if defined(SL_CATALOG_POWER_MANAGER_PRESENT)
+  // Ports C and D are powered down in EM2
+  if (!this->is_pin_available_in_em2(s0_pin) || (s1_pin != PIN_NAME_NC && !this->is_pin_available_in_em2(s1_pin))) {
+    sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
+    this->em1_required = true;
+  }
+#endif // SL_CATALOG_POWER_MANAGER_PRESENT
+
+  this->running = true;
+  return SL_STATUS_OK;
+}
+
+void PulseCounterClass::route_pin(PinName pin, volatile uint32_t *route)
+{
+  GPIO_Port_TypeDef port = getSilabsPortFromArduinoPin(pin);
+  uint32_t gpio_pin = getSilabsPinFromArduinoPin(pin);
+  GPIO_PinModeSet(port, gpio_pin, gpioModeInput, 0);
+  *route = ((uint32_t)port << _GPIO_PCNT_S0INROUTE_PORT_SHIFT) | (gpio_pin << _GPIO_PCNT_S0INROUTE_PIN_SHIFT);
+}
+
+bool PulseCounterClass::is_pin_available_in_em2(PinName pin)
+{
+  GPIO_Port_TypeDef port = getSilabsPortFromArduinoPin(pin);
+  return port == gpioPortA || port == gpioPortB;
+}
+
+bool PulseCounterClass::is_externally_clocked()
+{
+  return this->mode == PCNT_CFG_MODE_EXTCLKSINGLE || this->mode == PCNT_CFG_MODE_EXTCLKQUAD;
+}
+
+void PulseCounterClass::end()
+{
+  if (!this->running) {
+    return;
+  }
+
+  NVIC_DisableIRQ(PCNT0_IRQn);
+  PCNT0->IEN = 0u;
+  // The disabling is synchronized by the counter clock - the low frequency clock finishes it
+  // within a few cycles, but an external clock needs input edges which may never come
+  PCNT0->EN_CLR = PCNT_EN_EN;
+  uint32_t disable_start = micros();
+  while ((PCNT0->EN & PCNT_EN_DISABLING) && (micros() - disable_start) < this->disable_timeout_us) ;
+  if (PCNT0->EN & PCNT_EN_DISABLING) {
+    // Reset the peripheral instead, the clock source is only changed at the next start while it's disabled
+    PCNT0->SWRST_SET = PCNT_SWRST_SWRST;
+    disable_start = micros();
+    while ((PCNT0->SWRST & PCNT_SWRST_RESETTING) && (micros() - disable_start) < this->disable_timeout_us) ;
+  }
+  PCNT0->IF_CLR = _PCNT_IF_MASK;
+  NVIC_ClearPendingIRQ(PCNT0_IRQn);
+  CMU_ClockEnable(cmuClock_PCNT0, false);
+
+  GPIO->PCNTROUTE[0].S0INROUTE = 0u;
+  GPIO->PCNTROUTE[0].S1INROUTE = 0u;
+  GPIO_PinModeSet(getSilabsPortFromArduinoPin(this->s0_pin), getSilabsPinFromArduinoPin(this->s0_pin), gpioModeDisabled, 0);
+  if (this->s1_pin != PIN_NAME_NC) {
+    GPIO_PinModeSet(getSilabsPortFromArduinoPin(this->s1_pin), getSilabsPinFromArduinoPin(this->s1_pin), gpioModeDisabled, 0);
+  }
+
+#if defined(SL_CATALOG_POWER_MANAGER_PRESENT)
+  if (this->em1_required) {
+    sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
+    this->em1_required = false;
+  }
+#endif // SL_CATALOG_POWER_MANAGER_PRESENT
+
+  // A top value waiting for a wrap is used at the next start
+  this->s0_pin = PIN_NAME_NC;
+  this->s1_pin = PIN_NAME_NC;
+  this->running = false;
+}
+
+uint32_t PulseCounterClass::get_raw_count()
+{
+  if (!this->running) {
+    return this->reset_base;
+  }
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  uint32_t wrapped_count = this->wrapped_count;
+  uint32_t counter = PCNT0->CNT;
+  uint32_t pending_flags = PCNT0->IF;
+  uint32_t period = (uint32_t)this->top + 1u;
+  // Account for a wrap which happened after the interrupts were disabled - the counter
+  // value tells whether it was read before or after the wrap
+  if ((pending_flags & PCNT_IF_OF) && counter < period / 2u) {
+    wrapped_count += period;
+  }
+  if ((pending_flags & PCNT_IF_UF) && counter >= period / 2u) {
+    wrapped_count -= period;
+  }
+  CORE_EXIT_ATOMIC();
+
+  return wrapped_count + counter;
+}
+
+int32_t PulseCounterClass::get_count()
+{
+  return (int32_t)(this->get_raw_count() - this->reset_base);
+}
+
+void PulseCounterClass::reset_count()
+{
+  this->reset_base = this->get_raw_count();
+}
+
+sl_status_t PulseCounterClass::set_top(uint16_t top)
+{
+  if (!this->running) {
+    this->top = top;
+    this->top_pending = false;
+    return SL_STATUS_OK;
+  }
+
+  // The previous value has to be loaded or synchronized before the buffer can be written again
+  if (this->top_pending || (PCNT0->SYNCBUSY & PCNT_SYNCBUSY_TOPB)) {
+    return SL_STATUS_BUSY;
+  }
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  this->pending_top = top;
+  this->top_pending = true;
+  PCNT0->TOPB = top;
+  CORE_EXIT_ATOMIC();
+  return SL_STATUS_OK;
+}
+
+uint16_t PulseCounterClass::get_top()
+{
+  return this->top;
+}
+
+void PulseCounterClass::attach_overflow_callback(void (*callback)(void))
+{
+  this->user_overflow_callback = callback;
+}
+
+void PulseCounterClass::attach_underflow_callback(void (*callback)(void))
+{
+  this->user_underflow_callback = callback;
+}
+
+uint32_t PulseCounterClass::get_quadrature_error_count()
+{
+  return this->quadrature_error_count;
+}
+
+bool PulseCounterClass::is_running()
+{
+  return this->running;
+}
+
+void PulseCounterClass::handle_irq()
+{
+  uint32_t flags = PCNT0->IF & PCNT0->IEN;
+  PCNT0->IF_CLR = flags;
+
+  // The counter wrapped with the old top value - the buffered one is loaded at the wrap
+  uint32_t period = (uint32_t)this->top + 1u;
+  if (flags & (PCNT_IF_OF | PCNT_IF_UF)) {
+    if (flags & PCNT_IF_OF) {
+      this->wrapped_count = this->wrapped_count + period;
+    }
+    if (flags & PCNT_IF_UF) {
+      this->wrapped_count = this->wrapped_count - period;
+    }
+    if (this->top_pending) {
+      this->top = this->pending_top;
+      this->top_pending = false;
+    }
+  }
+
+  if (flags & PCNT_IF_OQSTERR) {
+    this->quadrature_error_count = this->quadrature_error_count + 1u;
+  }
+
+  if ((flags & PCNT_IF_OF) && this->user_overflow_callback) {
+    this->user_overflow_callback();
+  }
+  if ((flags & PCNT_IF_UF) && this->user_underflow_callback) {
+    this->user_underflow_callback();
+  }
+}
+
+void PCNT0_IRQHandler(void)
+{
+  PulseCounter.handle_irq();
+}
+
+arduino::PulseCounterClass PulseCounter;
+
+#endif // PCNT_PRESENT
@@ -0,0 +1,235 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Arduino.h"
+
+#ifndef __ARDUINO_PCNT_H
+#define __ARDUINO_PCNT_H
+
+#if defined(PCNT_PRESENT)
+
+#include "em_cmu.h"
+#include "em_core.h"
+#include "sl_status.h"
+
+namespace arduino {
+class PulseCounterClass {
+public:
+  /***************************************************************************//**
+   * Constructor for PulseCounterClass
+   ******************************************************************************/
+  PulseCounterClass();
+
+  /***************************************************************************//**
+   * Starts counting the edges of a single input pin in hardware
+   *
+   * The input pin clocks the counter directly, so there's no interrupt per edge
+   * and the counting goes on in EM2 and EM3 without any CPU involvement.
+   * The hardware counter is 16 bits wide - it's extended to 32 bits in software
+   * with one interrupt on every wrap.
+   * The input edges also synchronize the configuration, so the first
+   * few edges after the start are not counted.
+   * Ports C and D are not available for peripherals in EM2, so counting on these
+   * pins keeps the device in EM1.
+   *
+   * @param[in] pin The input pin
+   * @param[in] edge The counted edge - RISING or FALLING
+   *
+   * @return Status of the start process
+   ******************************************************************************/
+  sl_status_t begin(PinName pin, PinStatus edge = RISING);
+  sl_status_t begin(pin_size_t pin, PinStatus edge = RISING);
+
+  /***************************************************************************//**
+   * Starts decoding a quadrature encoder in hardware
+   *
+   * With the default 1x resolution the A input clocks the counter and the level
+   * of the B input selects the direction - this works up to the MHz range and in EM2.
+   * The 2x and 4x resolutions count every edge of A (and B) by oversampling
+   * the inputs with the 32.768 kHz low frequency clock - these only follow
+   * encoders up to a few kHz, but filter the contact bounce and count the
+   * direction errors.
+   *
+   * @param[in] pin_a The A input of the encoder
+   * @param[in] pin_b The B input of the encoder
+   * @param[in] resolution The counted edges per encoder period - 1, 2 or 4
+   *
+   * @return Status of the start process
+   ******************************************************************************/
+  sl_status_t begin_quadrature(PinName pin_a, PinName pin_b, uint8_t resolution = 1u);
+  sl_status_t begin_quadrature(pin_size_t pin_a, pin_size_t pin_b, uint8_t resolution = 1u);
+
+  /***************************************************************************//**
+   * Stops the counter and releases the pins
+   ******************************************************************************/
+  void end();
+
+  /***************************************************************************//**
+   * Returns the number of counted pulses since the start or the last reset
+   *
+   * @return the counted pulses - negative if a quadrature encoder turned backwards
+   ******************************************************************************/
+  int32_t get_count();
+
+  /***************************************************************************//**
+   * Restarts counting from zero
+   *
+   * The hardware counter keeps running, so no pulse is missed around the reset.
+   ******************************************************************************/
+  void reset_count();
+
+  /***************************************************************************//**
+   * Sets the top value of the hardware counter
+   *
+   * The counter wraps to zero after reaching the top value and calls the overflow
+   * callback - a top value of N-1 gives a callback after every N pulses.
+   * The counted value returned by get_count() is not affected.
+   * When called before begin() the counter starts with the new top value.
+   * While counting the new value is buffered and takes effect at the next wrap,
+   * so the current counter period is never cut short or extended.
+   *
+   * @param[in] top The top value of the counter
+   *
+   * @return SL_STATUS_OK or SL_STATUS_BUSY if the previous change
+   *         has not been taken over by the counter yet
+   ******************************************************************************/
+  sl_status_t set_top(uint16_t top);
+
+  /***************************************************************************//**
+   * Returns the top value the hardware counter currently wraps at
+   *
+   * @return the top value
+   ******************************************************************************/
+  uint16_t get_top();
+
+  /***************************************************************************//**
+   * Attaches a callback to the counter passing the top value
+   *
+   * The callback is called from an interrupt.
+   *
+   * @param[in] callback The callback - nullptr to detach it
+   ******************************************************************************/
+  void attach_overflow_callback(void (*callback)(void));
+
+  /***************************************************************************//**
+   * Attaches a callback to the counter going below zero while counting down
+   *
+   * The callback is called from an interrupt.
+   *
+   * @param[in] callback The callback - nullptr to detach it
+   ******************************************************************************/
+  void attach_underflow_callback(void (*callback)(void));
+
+  /***************************************************************************//**
+   * Returns the number of invalid state transitions seen by the 2x and 4x
+   * quadrature decoders - these are caused by noise or a too fast encoder
+   *
+   * @return the number of errors since the start
+   ******************************************************************************/
+  uint32_t get_quadrature_error_count();
+
+  /***************************************************************************//**
+   * Returns whether the counter is running
+   *
+   * @return true if the counter is running
+   ******************************************************************************/
+  bool is_running();
+
+  /***************************************************************************//**
+   * Handles the PCNT interrupts
+   ******************************************************************************/
+  void handle_irq();
+
+private:
+  /***************************************************************************//**
+   * Configures and starts the counter
+   *
+   * @param[in] s0_pin The pin routed to the S0 input
+   * @param[in] s1_pin The pin routed to the S1 input - PIN_NAME_NC if not used
+   * @param[in] mode The PCNT_CFG_MODE value
+   * @param[in] ctrl The PCNT_CTRL value
+   *
+   * @return Status of the start process
+   ******************************************************************************/
+  sl_status_t start(PinName s0_pin, PinName s1_pin, uint32_t mode, uint32_t ctrl);
+
+  /***************************************************************************//**
+   * Routes a pin to a PCNT input
+   *
+   * @param[in] pin The pin
+   * @param[in] route The S0INROUTE or S1INROUTE register of the PCNT
+   ******************************************************************************/
+  void route_pin(PinName pin, volatile uint32_t *route);
+
+  /***************************************************************************//**
+   * Returns whether a pin keeps working as a peripheral input in EM2
+   *
+   * @param[in] pin The pin
+   *
+   * @return true if the pin is usable in EM2
+   ******************************************************************************/
+  bool is_pin_available_in_em2(PinName pin);
+
+  /***************************************************************************//**
+   * Returns whether the counter is clocked by its S0 input
+   *
+   * @return true in the external clock modes
+   ******************************************************************************/
+  bool is_externally_clocked();
+
+  /***************************************************************************//**
+   * Returns the extended counter value without the reset applied
+   *
+   * @return the pulses counted since the start
+   ******************************************************************************/
+  uint32_t get_raw_count();
+
+  bool running;
+  bool em1_required;
+  uint32_t mode;
+  PinName s0_pin;
+  PinName s1_pin;
+  uint16_t top;
+  // The top value waiting in the buffer for the next wrap
+  uint16_t pending_top;
+  bool top_pending;
+  // The pulses counted by the previous wraps of the hardware counter
+  volatile uint32_t wrapped_count;
+  uint32_t reset_base;
+  volatile uint32_t quadrature_error_count;
+  void (*user_overflow_callback)(void);
+  void (*user_underflow_callback)(void);
+
+  // The longest wait for the counter to disable - about 30 cycles of the low frequency clock
+  static const uint32_t disable_timeout_us = 1000u;
+};
+} // namespace arduino
+
+extern arduino::PulseCounterClass PulseCounter;
+
+#endif // PCNT_PRESENT
+
+#endif // __ARDUINO_PCNT_H
@@ -28,162 +28,494 @@
 
 using namespace arduino;
 
+static bool pwm_sequence_dma_pass_done_cb(unsigned int channel, unsigned int sequenceNo, void *userParam);
+
 PwmClass::PwmClass() :
-  pwm_mode(pwm_mode_t::DUTY_CYCLE),
   auto_deinit(true),
   pwm_mutex(nullptr),
-  duty_cycle_set_time(0u),
   duty_cycle_mode_write_resolution(8),
   duty_cycle_mode_max_value(255)
 {
-  pwm_config = {
-    .frequency = this->duty_cycle_mode_default_freq,
-    .polarity  = PWM_ACTIVE_HIGH,
-  };
+  for (auto& pwm_timer : this->pwm_timers) {
+    pwm_timer.timer = nullptr;
+    pwm_timer.clock = cmuClock_TIMER0;
+    pwm_timer.frequency = 0;
+    pwm_timer.prescale = 1u;
+    pwm_timer.top = 0u;
+  }
 
-  for (auto& pwm_pin : pwm_pins) {
+  for (auto& pwm_pin : this->pwm_pins) {
     pwm_pin.pin = PIN_NAME_MAX;
-    pwm_pin.inst.timer = TIMER0;
-    pwm_pin.inst.channel = 0;
-    pwm_pin.inst.port = gpioPortA;
-    pwm_pin.inst.pin = 0;
-    pwm_pin.inst.location = 0;
+    pwm_pin.mode = pwm_mode_t::DUTY_CYCLE;
+    pwm_pin.compare_value = this->compare_value_unset;
+    pwm_pin.timer_idx = 0u;
+    pwm_pin.cc_channel = 0u;
+  }
+
+  for (auto& pwm_sequence : this->pwm_sequences) {
+    pwm_sequence.active = false;
+    pwm_sequence.pwm_channel_idx = 0u;
+    pwm_sequence.dma_channel = 0u;
+    pwm_sequence.repeat = 0u;
+    pwm_sequence.passes_done = 0u;
+    pwm_sequence.callback = nullptr;
   }
 
   this->pwm_mutex = xSemaphoreCreateMutexStatic(&this->pwm_mutex_buf);
   configASSERT(this->pwm_mutex);
 }
 
-bool PwmClass::init(PinName pin, int frequency)
+uint8_t PwmClass::attach(PinName pin, int frequency, pwm_mode_t mode, bool for_sequence)
 {
-  uint8_t pwm_channel_idx = get_next_free_pwm_channel_idx();
+  uint8_t pwm_channel_idx = get_pwm_channel_idx_for_pin(pin);
+  if (pwm_channel_idx != UINT8_MAX) {
+    pwm_pin_t *pwm_pin = &this->pwm_pins[pwm_channel_idx];
+    pwm_pin->mode = mode;
+    // Nothing to do if the pin is already running at the frequency on a suitable timer
+    if (this->pwm_timers[pwm_pin->timer_idx].frequency == frequency
+        && (!for_sequence || this->is_timer_suitable_for_sequence(pwm_pin->timer_idx))) {
+      return pwm_channel_idx;
+    }
+    // Move the pin to another timer
+    this->detach(pwm_channel_idx);
+  }
+
+  pwm_channel_idx = get_next_free_pwm_channel_idx();
   if (pwm_channel_idx == UINT8_MAX) {
     // No more free PWM channels available
+    return UINT8_MAX;
+  }
+  uint8_t timer_idx = this->get_timer_for_frequency(frequency, for_sequence);
+  if (timer_idx == UINT8_MAX) {
+    // No more free timers available
+    return UINT8_MAX;
+  }
+
+  pwm_pin_t *pwm_pin = &this->pwm_pins[pwm_channel_idx];
+  pwm_pin->pin = pin;
+  pwm_pin->mode = mode;
+  pwm_pin->timer_idx = timer_idx;
+  pwm_pin->cc_channel = this->get_free_cc_channel(timer_idx);
+  // Mark the duty cycle as unset, so the first request is always applied
+  pwm_pin->compare_value = this->compare_value_unset;
+
+  GPIO_Port_TypeDef port = getSilabsPortFromArduinoPin(pin);
+  uint8_t gpio_pin = getSilabsPinFromArduinoPin(pin);
+  GPIO_PinModeSet(port, gpio_pin, gpioModePushPull, 0);
+
+  // Start from 0% duty cycle and route the channel output to the pin
+  TIMER_TypeDef *timer = this->pwm_timers[timer_idx].timer;
+  TIMER_CompareSet(timer, pwm_pin->cc_channel, 0u);
+  TIMER_CompareBufSet(timer, pwm_pin->cc_channel, 0u);
+  volatile uint32_t *cc_route = &GPIO->TIMERROUTE[TIMER_NUM(timer)].CC0ROUTE + pwm_pin->cc_channel;
+  *cc_route = ((uint32_t)port << _GPIO_TIMER_CC0ROUTE_PORT_SHIFT) | ((uint32_t)gpio_pin << _GPIO_TIMER_CC0ROUTE_PIN_SHIFT);
+  GPIO->TIMERROUTE_SET[TIMER_NUM(timer)].ROUTEEN = 1u << (pwm_pin->cc_channel + _GPIO_TIMER_ROUTEEN_CC0PEN_SHIFT);
+  return pwm_channel_idx;
+}
+
+void PwmClass::detach(uint8_t pwm_channel_idx)
+{
+  this->abort_sequence(pwm_channel_idx);
+  pwm_pin_t *pwm_pin = &this->pwm_pins[pwm_channel_idx];
+  TIMER_TypeDef *timer = this->pwm_timers[pwm_pin->timer_idx].timer;
+
+  // Disconnect the channel from the pin and drive it low
+  GPIO->TIMERROUTE_CLR[TIMER_NUM(timer)].ROUTEEN = 1u << (pwm_pin->cc_channel + _GPIO_TIMER_ROUTEEN_CC0PEN_SHIFT);
+  GPIO_PinOutClear(getSilabsPortFromArduinoPin(pwm_pin->pin), getSilabsPinFromArduinoPin(pwm_pin->pin));
+  TIMER_CompareBufSet(timer, pwm_pin->cc_channel, 0u);
+  pwm_pin->pin = PIN_NAME_MAX;
+
+  // Stop the timer if there are no users left
+  if (this->get_num_of_pwm_channels_on_timer(pwm_pin->timer_idx) == 0u) {
+    this->deinit_timer(pwm_pin->timer_idx);
+  }
+}
+
+uint8_t PwmClass::get_timer_for_frequency(int frequency, bool for_sequence)
+{
+  // Share a running timer if possible
+  for (uint8_t i = 0; i < this->max_pwm_timers; i++) {
+    if (this->pwm_timers[i].timer != nullptr
+        && this->pwm_timers[i].frequency == frequency
+        && this->get_free_cc_channel(i) != UINT8_MAX
+        && (!for_sequence || this->is_timer_suitable_for_sequence(i))) {
+      return i;
+    }
+  }
+
+  // Start a new one otherwise
+  uint8_t max_counter_bits = for_sequence ? this->sequence_timer_counter_bits : 32u;
+  for (uint8_t i = 0; i < this->max_pwm_timers; i++) {
+    if (this->pwm_timers[i].timer == nullptr) {
+      return this->init_timer(i, frequency, max_counter_bits) ? i : UINT8_MAX;
+    }
+  }
+  return UINT8_MAX;
+}
+
+bool PwmClass::is_timer_suitable_for_sequence(uint8_t timer_idx)
+{
+  return TIMER_MaxCount(this->pwm_timers[timer_idx].timer) < (1u << this->sequence_timer_counter_bits)
+         && !this->pwm_sequences[timer_idx].active;
+}
+
+void PwmClass::abort_sequence(uint8_t pwm_channel_idx)
+{
+  pwm_sequence_t *pwm_sequence = &this->pwm_sequences[this->pwm_pins[pwm_channel_idx].timer_idx];
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  if (pwm_sequence->active && pwm_sequence->pwm_channel_idx == pwm_channel_idx) {
+    DMADRV_StopTransfer(pwm_sequence->dma_channel);
+    DMADRV_FreeChannel(pwm_sequence->dma_channel);
+    pwm_sequence->active = false;
+    // The compare value is not known anymore
+    this->pwm_pins[pwm_channel_idx].compare_value = this->compare_value_unset;
+  }
+  CORE_EXIT_ATOMIC();
+}
+
+uint8_t PwmClass::get_free_cc_channel(uint8_t timer_idx)
+{
+  uint8_t used_cc_channels = 0u;
+  for (auto& pwm_pin : this->pwm_pins) {
+    if (pwm_pin.pin != PIN_NAME_MAX && pwm_pin.timer_idx == timer_idx) {
+      used_cc_channels |= (uint8_t)(1u << pwm_pin.cc_channel);
+    }
+  }
+  for (uint8_t cc = 0; cc < this->cc_channels_per_timer; cc++) {
+    if ((used_cc_channels & (1u << cc)) == 0u) {
+      return cc;
+    }
+  }
+  return UINT8_MAX;
+}
+
+bool PwmClass::init_timer(uint8_t timer_idx, int frequency, uint8_t max_counter_bits)
+{
+  pwm_timer_t *pwm_timer = &this->pwm_timers[timer_idx];
+  TIMER_TypeDef *timer = TimerAllocator.allocate(max_counter_bits);
+  if (timer == nullptr) {
     return false;
   }
 
+  uint32_t prescale;
+  uint32_t top;
+  CMU_Clock_TypeDef clock;
+  if (!TimerAllocator.get_clock(timer, &clock)
+      || !this->calculate_timer_period(CMU_ClockFreqGet(clock), TIMER_MaxCount(timer), frequency, &prescale, &top)) {
+    TimerAllocator.release(timer);
+    return false;
+  }
+
+  CMU_ClockEnable(clock, true);
+  TIMER_Init_TypeDef timer_init = TIMER_INIT_DEFAULT;
+  timer_init.enable = false;
+  timer_init.prescale = (TIMER_Prescale_TypeDef)(prescale - 1u);
+  // Clear the overflow DMA request when the LDMA picks it up for a sequence
+  timer_init.dmaClrAct = true;
+  TIMER_Init(timer, &timer_init);
+
+  // The channel configuration can't be changed while the timer is running - set up all of them in PWM mode
+  TIMER_InitCC_TypeDef cc_init = TIMER_INITCC_DEFAULT;
+  cc_init.mode = timerCCModePWM;
+  for (uint8_t cc = 0; cc < this->cc_channels_per_timer; cc++) {
+    TIMER_InitCC(timer, cc, &cc_init);
+  }
+
+  TIMER_TopSet(timer, top);
+  TIMER_Enable(timer, true);
+
   #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
   // Require at least EM1 to keep the timer peripheral running
   sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
   #endif // SL_CATALOG_POWER_MANAGER_PRESENT
 
-  this->pwm_pins[pwm_channel_idx].pin = pin;
-  this->pwm_pins[pwm_channel_idx].duty_cycle_percent = 101;
-  this->pwm_pins[pwm_channel_idx].inst.port = getSilabsPortFromArduinoPin(pin);
-  this->pwm_pins[pwm_channel_idx].inst.pin = getSilabsPinFromArduinoPin(pin);
-  this->pwm_pins[pwm_channel_idx].inst.channel = pwm_channel_idx;
-
-  GPIO_PinModeSet(this->pwm_pins[pwm_channel_idx].inst.port, this->pwm_pins[pwm_channel_idx].inst.pin, gpioModePushPull, 0);
-  pwm_config.frequency = frequency;
-  sl_pwm_init(&this->pwm_pins[pwm_channel_idx].inst, &pwm_config);
-  sl_pwm_start(&this->pwm_pins[pwm_channel_idx].inst);
+  pwm_timer->timer = timer;
+  pwm_timer->clock = clock;
+  pwm_timer->frequency = frequency;
+  pwm_timer->prescale = prescale;
+  pwm_timer->top = top;
   return true;
 }
 
-void PwmClass::duty_cycle_mode(PinName pin, int duty_cycle)
+void PwmClass::deinit_timer(uint8_t timer_idx)
 {
-  if (duty_cycle < 0 || duty_cycle > (int)this->duty_cycle_mode_max_value || pin >= PIN_NAME_MAX) {
+  pwm_timer_t *pwm_timer = &this->pwm_timers[timer_idx];
+  if (pwm_timer->timer == nullptr) {
     return;
   }
+  TIMER_Reset(pwm_timer->timer);
+  CMU_ClockEnable(pwm_timer->clock, false);
+  TimerAllocator.release(pwm_timer->timer);
+
+  #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
+  // Remove the energy mode requirement
+  sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
+  #endif // SL_CATALOG_POWER_MANAGER_PRESENT
 
-  // If the previous duty cycle setting was within the stabilization time - we wait for the stabilization time to elapse
-  // If different channels's duty cycles are set in quick succession they won't take effect - therefore we have to wait in between
-  while (millis() < this->duty_cycle_set_time + this->pwm_stabilization_time_ms) {
-    yield();
+  pwm_timer->timer = nullptr;
+  pwm_timer->frequency = 0;
+}
+
+bool PwmClass::calculate_timer_period(uint32_t clock_freq, uint32_t max_count, int frequency, uint32_t *prescale, uint32_t *top)
+{
+  if (frequency <= 0) {
+    return false;
+  }
+  uint32_t timer_cycles = clock_freq / (uint32_t)frequency;
+  if (timer_cycles < 2u) {
+    return false;
   }
 
-  xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
+  // Use the smallest prescaler the period fits with - this gives the finest duty cycle steps
+  uint32_t div = ((timer_cycles - 1u) / max_count) + 1u;
+  if (div > this->max_timer_prescale) {
+    return false;
+  }
+  *prescale = div;
+  *top = (timer_cycles / div) - 1u;
+  return true;
+}
 
-  // If the PWM was running in a different mode before - deinitialize it
-  if (this->pwm_mode != pwm_mode_t::DUTY_CYCLE) {
-    deinit_all_pwm_channels();
-    this->pwm_mode = pwm_mode_t::DUTY_CYCLE;
+uint8_t PwmClass::get_resolution_for_top(uint32_t top)
+{
+  // The number of distinct duty cycles is the period length plus one (for the always high output)
+  uint8_t resolution = 0u;
+  while (resolution < 32u && (((uint64_t)1u << (resolution + 1u)) <= ((uint64_t)top + 2u))) {
+    resolution++;
   }
+  return resolution;
+}
 
-  // Initialize PWM if the pin doesn't have an initialized instance
-  if (get_pwm_channel_idx_for_pin(pin) == UINT8_MAX) {
-    bool res = this->init(pin, this->duty_cycle_mode_default_freq);
-    // Return if PWM could not be initialized
-    if (!res) {
-      xSemaphoreGive(this->pwm_mutex);
-      return;
+uint32_t PwmClass::get_compare_value(uint8_t timer_idx, uint32_t duty_cycle, uint32_t max_value)
+{
+  pwm_timer_t *pwm_timer = &this->pwm_timers[timer_idx];
+  // Scale to the timer period with rounding - a compare value above the top keeps the output high for the whole period
+  uint64_t period = (uint64_t)pwm_timer->top + 1u;
+  uint32_t compare_value = (uint32_t)(((period * duty_cycle) + (max_value / 2u)) / max_value);
+  uint32_t max_count = TIMER_MaxCount(pwm_timer->timer);
+  if (compare_value > max_count) {
+    compare_value = max_count;
+  }
+  return compare_value;
+}
+
+uint8_t PwmClass::prepare_duty_cycle(PinName pin, int duty_cycle, int frequency, uint32_t *compare_value)
+{
+  if (duty_cycle < 0 || duty_cycle > (int)this->duty_cycle_mode_max_value || pin >= PIN_NAME_MAX) {
+    return UINT8_MAX;
+  }
+
+  uint8_t pwm_channel_idx = get_pwm_channel_idx_for_pin(pin);
+  // Setting the duty cycle stops the sequence playing on the pin
+  if (pwm_channel_idx != UINT8_MAX) {
+    this->abort_sequence(pwm_channel_idx);
+  }
+  if (frequency == 0) {
+    // Keep the frequency of pins already in duty cycle mode
+    if (pwm_channel_idx != UINT8_MAX && this->pwm_pins[pwm_channel_idx].mode == pwm_mode_t::DUTY_CYCLE) {
+      frequency = this->pwm_timers[this->pwm_pins[pwm_channel_idx].timer_idx].frequency;
+    } else {
+      frequency = this->duty_cycle_mode_default_freq;
+    }
+  }
+
+  // A zero duty cycle stops the output with auto deinit - no need to start it
+  if (duty_cycle == 0 && this->auto_deinit) {
+    if (pwm_channel_idx != UINT8_MAX) {
+      this->detach(pwm_channel_idx);
     }
+    return UINT8_MAX;
+  }
+
+  pwm_channel_idx = this->attach(pin, frequency, pwm_mode_t::DUTY_CYCLE);
+  // Return if PWM could not be initialized
+  if (pwm_channel_idx == UINT8_MAX) {
+    return UINT8_MAX;
   }
-  // Calculate the duty cycle percent from the provided value
+  pwm_pin_t *pwm_pin = &this->pwm_pins[pwm_channel_idx];
+
   // Arduino passes the duty cycle as a number from 0 to the configured write resolution's max (255 by default).
-  // We need the duty cycle to be expressed as a number from 0-100.
-  int duty_cycle_percent = duty_cycle * 100 / this->duty_cycle_mode_max_value;
+  // It's scaled directly to the timer period, so the output has as many steps as the timer can provide.
+  uint32_t new_compare_value = this->get_compare_value(pwm_pin->timer_idx, (uint32_t)duty_cycle, this->duty_cycle_mode_max_value);
 
-  uint8_t pwm_channel_idx = get_pwm_channel_idx_for_pin(pin);
   // Don't change anything if the requested duty cycle is the same as the currently set
-  if (this->pwm_pins[pwm_channel_idx].duty_cycle_percent == (uint8_t)duty_cycle_percent) {
-    xSemaphoreGive(this->pwm_mutex);
+  if (pwm_pin->compare_value == new_compare_value) {
+    return UINT8_MAX;
+  }
+  pwm_pin->compare_value = new_compare_value;
+  *compare_value = new_compare_value;
+  return pwm_channel_idx;
+}
+
+void PwmClass::write_compare_values(const uint8_t *pwm_channel_idxs, const uint32_t *compare_values, uint8_t count)
+{
+  if (count == 0u) {
     return;
   }
-  this->pwm_pins[pwm_channel_idx].duty_cycle_percent = (uint8_t)duty_cycle_percent;
 
-  // Stop the PWM on 0 duty cycle (if auto deinit is enabled), set the requested duty cycle otherwise
-  if (duty_cycle_percent == 0 && this->auto_deinit) {
-    this->stop(pin);
-  } else {
-    sl_pwm_set_duty_cycle(&this->pwm_pins[pwm_channel_idx].inst, (uint8_t)duty_cycle_percent);
-    this->duty_cycle_set_time = millis();
+  // The buffered compare values are latched on the next overflow - writing all channels of a timer within
+  // the same period makes them take effect together without having to wait for the period to end
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  for (uint8_t timer_idx = 0; timer_idx < this->max_pwm_timers; timer_idx++) {
+    pwm_timer_t *pwm_timer = &this->pwm_timers[timer_idx];
+    uint8_t num_of_writes = 0u;
+    for (uint8_t i = 0; i < count; i++) {
+      if (this->pwm_pins[pwm_channel_idxs[i]].timer_idx == timer_idx) {
+        num_of_writes++;
+      }
+    }
+    if (num_of_writes == 0u) {
+      continue;
+    }
+
+    // If the overflow is about to happen let it pass first, so it can't split the writes
+    uint32_t write_margin = (this->compare_write_cpu_cycles / pwm_timer->prescale) + 1u;
+    if (num_of_writes > 1u && pwm_timer->top > (2u * write_margin)) {
+      while ((pwm_timer->top - TIMER_CounterGet(pwm_timer->timer)) < write_margin) {
+        ;
+      }
+    }
+    for (uint8_t i = 0; i < count; i++) {
+      pwm_pin_t *pwm_pin = &this->pwm_pins[pwm_channel_idxs[i]];
+      if (pwm_pin->timer_idx == timer_idx) {
+        TIMER_CompareBufSet(pwm_timer->timer, pwm_pin->cc_channel, compare_values[i]);
+      }
+    }
   }
+  CORE_EXIT_ATOMIC();
+}
 
+void PwmClass::set_duty_cycles(const PinName *pins, const int *duty_cycles, uint8_t count, int frequency)
+{
+  uint8_t pwm_channel_idxs[max_pwm_channels];
+  uint32_t compare_values[max_pwm_channels];
+  uint8_t num_of_writes = 0u;
+  for (uint8_t i = 0; i < count; i++) {
+    uint32_t compare_value;
+    uint8_t pwm_channel_idx = this->prepare_duty_cycle(pins[i], duty_cycles[i], frequency, &compare_value);
+    if (pwm_channel_idx == UINT8_MAX) {
+      continue;
+    }
+    // A pin listed multiple times gets its last duty cycle
+    uint8_t write_idx = 0u;
+    while (write_idx < num_of_writes && pwm_channel_idxs[write_idx] != pwm_channel_idx) {
+      write_idx++;
+    }
+    if (write_idx == num_of_writes) {
+      num_of_writes++;
+    }
+    pwm_channel_idxs[write_idx] = pwm_channel_idx;
+    compare_values[write_idx] = compare_value;
+  }
+
+  // Drop the channels which have been stopped by a later entry of the list
+  uint8_t num_of_valid_writes = 0u;
+  for (uint8_t i = 0; i < num_of_writes; i++) {
+    if (this->pwm_pins[pwm_channel_idxs[i]].pin != PIN_NAME_MAX) {
+      pwm_channel_idxs[num_of_valid_writes] = pwm_channel_idxs[i];
+      compare_values[num_of_valid_writes] = compare_values[i];
+      num_of_valid_writes++;
+    }
+  }
+  this->write_compare_values(pwm_channel_idxs, compare_values, num_of_valid_writes);
+}
+
+void PwmClass::duty_cycle_mode(PinName pin, int duty_cycle)
+{
+  xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
+  this->set_duty_cycles(&pin, &duty_cycle, 1u, 0);
+  xSemaphoreGive(this->pwm_mutex);
+}
+
+void PwmClass::duty_cycle_mode(PinName pin, int duty_cycle, int frequency)
+{
+  if (frequency <= 0) {
+    return;
+  }
+  xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
+  this->set_duty_cycles(&pin, &duty_cycle, 1u, frequency);
+  xSemaphoreGive(this->pwm_mutex);
+}
+
+void PwmClass::duty_cycle_mode(const PinName *pins, const int *duty_cycles, uint8_t count)
+{
+  if (!pins || !duty_cycles || count == 0u || count > this->max_pwm_channels) {
+    return;
+  }
+  xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
+  this->set_duty_cycles(pins, duty_cycles, count, 0);
   xSemaphoreGive(this->pwm_mutex);
 }
 
 void PwmClass::frequency_mode(PinName pin, int frequency)
 {
-  // Frequency mode handles only one channel
   if (pin >= PIN_NAME_MAX) {
     return;
   }
   xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
 
-  // If the PWM was running in a different mode before - deinitialize it
-  if (this->pwm_mode != pwm_mode_t::FREQUENCY) {
-    deinit_all_pwm_channels();
+  uint8_t pwm_channel_idx = get_pwm_channel_idx_for_pin(pin);
+  if (pwm_channel_idx != UINT8_MAX) {
+    this->abort_sequence(pwm_channel_idx);
   }
-  this->pwm_mode = pwm_mode_t::FREQUENCY;
   // Stop waveform generation if the frequency is zero
   if (frequency == 0) {
-    this->stop(pin);
+    if (pwm_channel_idx != UINT8_MAX) {
+      this->detach(pwm_channel_idx);
+    }
     xSemaphoreGive(this->pwm_mutex);
     return;
   }
-  // Initialize PWM with the requested frequency
-  if (!this->init(pin, frequency)) {
+
+  // Retune the timer in place if the pin is its only user and the prescaler can stay the same
+  // The new period and duty cycle are latched together on the next overflow
+  if (pwm_channel_idx != UINT8_MAX) {
+    pwm_pin_t *pwm_pin = &this->pwm_pins[pwm_channel_idx];
+    pwm_timer_t *pwm_timer = &this->pwm_timers[pwm_pin->timer_idx];
+    uint32_t prescale;
+    uint32_t top;
+    if (pwm_timer->frequency != frequency
+        && this->get_num_of_pwm_channels_on_timer(pwm_pin->timer_idx) == 1u
+        && this->calculate_timer_period(CMU_ClockFreqGet(pwm_timer->clock), TIMER_MaxCount(pwm_timer->timer), frequency, &prescale, &top)
+        && prescale == pwm_timer->prescale) {
+      CORE_DECLARE_IRQ_STATE;
+      CORE_ENTER_ATOMIC();
+      pwm_timer->frequency = frequency;
+      pwm_timer->top = top;
+      TIMER_TopBufSet(pwm_timer->timer, top);
+      pwm_pin->mode = pwm_mode_t::FREQUENCY;
+      pwm_pin->compare_value = this->get_compare_value(pwm_pin->timer_idx, 1u, 2u);
+      TIMER_CompareBufSet(pwm_timer->timer, pwm_pin->cc_channel, pwm_pin->compare_value);
+      CORE_EXIT_ATOMIC();
+      xSemaphoreGive(this->pwm_mutex);
+      return;
+    }
+  }
+
+  // Move the pin to a timer running at the requested frequency otherwise
+  pwm_channel_idx = this->attach(pin, frequency, pwm_mode_t::FREQUENCY);
+  if (pwm_channel_idx == UINT8_MAX) {
     xSemaphoreGive(this->pwm_mutex);
     return;
   }
-  // Set the requested frequency
   // Arduino requires a 50% duty cycle in tone mode
-  uint8_t pwm_channel_idx = get_pwm_channel_idx_for_pin(pin);
-  sl_pwm_set_duty_cycle(&this->pwm_pins[pwm_channel_idx].inst, 50);
+  pwm_pin_t *pwm_pin = &this->pwm_pins[pwm_channel_idx];
+  pwm_pin->compare_value = this->get_compare_value(pwm_pin->timer_idx, 1u, 2u);
+  TIMER_CompareBufSet(this->pwm_timers[pwm_pin->timer_idx].timer, pwm_pin->cc_channel, pwm_pin->compare_value);
 
   xSemaphoreGive(this->pwm_mutex);
 }
 
 void PwmClass::stop(PinName pin)
 {
+  xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
   uint8_t pwm_channel_idx = this->get_pwm_channel_idx_for_pin(pin);
-  if (pwm_channel_idx == UINT8_MAX) {
-    return;
+  if (pwm_channel_idx != UINT8_MAX) {
+    this->detach(pwm_channel_idx);
   }
-  sl_pwm_stop(&this->pwm_pins[pwm_channel_idx].inst);
-
-  // Deinit the PWM peripheral if there are no users left
-  if (this->get_num_of_pwm_channels_in_use() == 0) {
-    sl_pwm_deinit(&this->pwm_pins[pwm_channel_idx].inst);
-
-    #ifdef SL_CATALOG_POWER_MANAGER_PRESENT
-    // Remove the energy mode requirement
-    sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
-    #endif // SL_CATALOG_POWER_MANAGER_PRESENT
-  }
-
-  this->pwm_pins[pwm_channel_idx].pin = PIN_NAME_MAX;
+  xSemaphoreGive(this->pwm_mutex);
 }
 
 void PwmClass::duty_cycle_mode_set_write_resolution(uint8_t resolution)
@@ -195,11 +527,165 @@ void PwmClass::duty_cycle_mode_set_write_resolution(uint8_t resolution)
   this->duty_cycle_mode_max_value = pow(2, this->duty_cycle_mode_write_resolution) - 1;
 }
 
+uint8_t PwmClass::duty_cycle_mode_get_effective_resolution(int frequency)
+{
+  uint32_t prescale;
+  uint32_t top;
+  // All the timers run from the same clock
+  if (!this->calculate_timer_period(CMU_ClockFreqGet(cmuClock_TIMER0), this->min_timer_max_count, frequency, &prescale, &top)) {
+    return 0u;
+  }
+  return this->get_resolution_for_top(top);
+}
+
+uint8_t PwmClass::duty_cycle_mode_get_effective_resolution(PinName pin)
+{
+  xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
+  uint8_t resolution = 0u;
+  uint8_t pwm_channel_idx = this->get_pwm_channel_idx_for_pin(pin);
+  if (pwm_channel_idx != UINT8_MAX) {
+    resolution = this->get_resolution_for_top(this->pwm_timers[this->pwm_pins[pwm_channel_idx].timer_idx].top);
+  }
+  xSemaphoreGive(this->pwm_mutex);
+  return resolution;
+}
+
 void PwmClass::set_auto_deinit(bool auto_deinit)
 {
   this->auto_deinit = auto_deinit;
 }
 
+sl_status_t PwmClass::play_sequence(PinName pin, const uint16_t *compares, uint32_t len, uint32_t repeat, void (*callback)(PinName pin))
+{
+  if (pin >= PIN_NAME_MAX || compares == nullptr || len == 0u || len > LDMA_DESCRIPTOR_MAX_XFER_SIZE) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
+
+  // Keep the frequency of pins already in duty cycle mode
+  int frequency = this->duty_cycle_mode_default_freq;
+  uint8_t pwm_channel_idx = get_pwm_channel_idx_for_pin(pin);
+  if (pwm_channel_idx != UINT8_MAX) {
+    this->abort_sequence(pwm_channel_idx);
+    if (this->pwm_pins[pwm_channel_idx].mode == pwm_mode_t::DUTY_CYCLE) {
+      frequency = this->pwm_timers[this->pwm_pins[pwm_channel_idx].timer_idx].frequency;
+    }
+  }
+
+  pwm_channel_idx = this->attach(pin, frequency, pwm_mode_t::DUTY_CYCLE, true);
+  if (pwm_channel_idx == UINT8_MAX) {
+    xSemaphoreGive(this->pwm_mutex);
+    return SL_STATUS_NO_MORE_RESOURCE;
+  }
+  pwm_pin_t *pwm_pin = &this->pwm_pins[pwm_channel_idx];
+  pwm_timer_t *pwm_timer = &this->pwm_timers[pwm_pin->timer_idx];
+  pwm_sequence_t *pwm_sequence = &this->pwm_sequences[pwm_pin->timer_idx];
+
+  LDMA_PeripheralSignal_t overflow_signal;
+  if (!TimerAllocator.get_overflow_dma_signal(pwm_timer->timer, &overflow_signal)) {
+    xSemaphoreGive(this->pwm_mutex);
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+
+  // Initialize DMA with default parameters
+  DMADRV_Init();
+  if (DMADRV_AllocateChannel(&pwm_sequence->dma_channel, NULL) != ECODE_EMDRV_DMADRV_OK) {
+    xSemaphoreGive(this->pwm_mutex);
+    return SL_STATUS_NO_MORE_RESOURCE;
+  }
+
+  pwm_sequence->pwm_channel_idx = pwm_channel_idx;
+  pwm_sequence->repeat = repeat;
+  pwm_sequence->passes_done = 0u;
+  pwm_sequence->callback = callback;
+  pwm_pin->compare_value = this->compare_value_unset;
+
+  // Write one compare value on every timer overflow - they're latched on the overflow after
+  // The descriptor links to itself to repeat the sequence - it's reloaded from memory for each pass
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+  pwm_sequence->descriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(compares, &pwm_timer->timer->CC[pwm_pin->cc_channel].OCB, len, 0);
+  #pragma GCC diagnostic pop
+  pwm_sequence->descriptor.xfer.size = ldmaCtrlSizeHalf;
+  pwm_sequence->descriptor.xfer.link = (repeat == 1u) ? 0u : 1u;
+  // Endless sequences play without any interrupts
+  pwm_sequence->descriptor.xfer.doneIfs = (repeat == 0u) ? 0u : 1u;
+  pwm_sequence->active = true;
+
+  LDMA_TransferCfg_t transfer_cfg = LDMA_TRANSFER_CFG_PERIPHERAL(overflow_signal);
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  DMADRV_LdmaStartTransfer((int)pwm_sequence->dma_channel,
+                           &transfer_cfg,
+                           &pwm_sequence->descriptor,
+                           (repeat == 0u) ? NULL : pwm_sequence_dma_pass_done_cb,
+                           (void *)(uintptr_t)pwm_pin->timer_idx);
+  // The first pass has been loaded - the second has to be the last one if only two were requested
+  if (repeat == 2u) {
+    pwm_sequence->descriptor.xfer.link = 0u;
+  }
+  CORE_EXIT_ATOMIC();
+
+  xSemaphoreGive(this->pwm_mutex);
+  return SL_STATUS_OK;
+}
+
+void PwmClass::stop_sequence(PinName pin)
+{
+  xSemaphoreTake(this->pwm_mutex, portMAX_DELAY);
+  uint8_t pwm_channel_idx = this->get_pwm_channel_idx_for_pin(pin);
+  if (pwm_channel_idx != UINT8_MAX) {
+    this->abort_sequence(pwm_channel_idx);
+  }
+  xSemaphoreGive(this->pwm_mutex);
+}
+
+bool PwmClass::is_sequence_playing(PinName pin)
+{
+  uint8_t pwm_channel_idx = this->get_pwm_channel_idx_for_pin(pin);
+  if (pwm_channel_idx == UINT8_MAX) {
+    return false;
+  }
+  pwm_sequence_t *pwm_sequence = &this->pwm_sequences[this->pwm_pins[pwm_channel_idx].timer_idx];
+  return pwm_sequence->active && pwm_sequence->pwm_channel_idx == pwm_channel_idx;
+}
+
+uint32_t PwmClass::get_sequence_period(int frequency)
+{
+  uint32_t prescale;
+  uint32_t top;
+  // All the timers run from the same clock
+  if (!this->calculate_timer_period(CMU_ClockFreqGet(cmuClock_TIMER0), (1u << this->sequence_timer_counter_bits) - 1u, frequency, &prescale, &top)) {
+    return 0u;
+  }
+  return top + 1u;
+}
+
+bool PwmClass::handle_sequence_pass_done(uint8_t timer_idx)
+{
+  pwm_sequence_t *pwm_sequence = &this->pwm_sequences[timer_idx];
+  if (!pwm_sequence->active) {
+    return false;
+  }
+  pwm_sequence->passes_done++;
+
+  // The next pass is already loaded when this one ends - unlink the descriptor for the one after,
+  // so the LDMA stops by itself exactly after the last pass
+  if (pwm_sequence->repeat - pwm_sequence->passes_done == 2u) {
+    pwm_sequence->descriptor.xfer.link = 0u;
+  }
+  if (pwm_sequence->passes_done < pwm_sequence->repeat) {
+    return true;
+  }
+
+  DMADRV_FreeChannel(pwm_sequence->dma_channel);
+  pwm_sequence->active = false;
+  if (pwm_sequence->callback) {
+    pwm_sequence->callback(this->pwm_pins[pwm_sequence->pwm_channel_idx].pin);
+  }
+  return false;
+}
+
 uint8_t PwmClass::get_next_free_pwm_channel_idx()
 {
   for (uint8_t i = 0; i < this->max_pwm_channels; i++) {
@@ -220,24 +706,22 @@ uint8_t PwmClass::get_pwm_channel_idx_for_pin(PinName pin)
   return UINT8_MAX;
 }
 
-uint8_t PwmClass::get_num_of_pwm_channels_in_use()
+uint8_t PwmClass::get_num_of_pwm_channels_on_timer(uint8_t timer_idx)
 {
   uint8_t count = 0u;
   for (auto& pwm_pin : this->pwm_pins) {
-    if (pwm_pin.pin != PIN_NAME_MAX) {
+    if (pwm_pin.pin != PIN_NAME_MAX && pwm_pin.timer_idx == timer_idx) {
       count++;
     }
   }
   return count;
 }
 
-void PwmClass::deinit_all_pwm_channels()
+static bool pwm_sequence_dma_pass_done_cb(unsigned int channel, unsigned int sequenceNo, void *userParam)
 {
-  for (auto& pwm_pin : this->pwm_pins) {
-    if (pwm_pin.pin != PIN_NAME_MAX) {
-      this->stop(pwm_pin.pin);
-    }
-  }
+  (void)channel;
+  (void)sequenceNo;
+  return PWM.handle_sequence_pass_done((uint8_t)(uintptr_t)userParam);
 }
 
 arduino::PwmClass PWM;
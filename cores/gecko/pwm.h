@@ -33,10 +33,16 @@
 #include <inttypes.h>
 #include "pinDefinitions.h"
 #include "wiring_private.h"
-#include "sl_pwm.h"
+#include "em_cmu.h"
+#include "em_core.h"
 #include "em_gpio.h"
+#include "em_ldma.h"
+#include "em_timer.h"
 #include "FreeRTOS.h"
 #include "semphr.h"
+#include "dmadrv.h"
+#include "sl_status.h"
+#include "timer_allocator.h"
 
 extern "C" {
   #include "sl_power_manager.h"
@@ -55,17 +61,43 @@ public:
    * In this mode the frequency is fixed at a constant value and the duty
    * cycle is variable by the user. Used for 'analogWrite'.
    * Can handle multiple channels.
+   * The duty cycle is written to the buffered compare register of the timer,
+   * so it takes effect at the start of the next PWM period without any waiting.
+   * New pins start at the default frequency (1 kHz), pins already in duty
+   * cycle mode keep their frequency.
    *
    * @param[in] pin output pin for the PWM signal
    * @param[in] duty_cycle duty cycle for the PWM signal (0-255)
    *****************************************************************************/
   void duty_cycle_mode(PinName pin, int duty_cycle);
 
+  /**************************************************************************//**
+   * PWM signal generation in duty cycle mode with a custom frequency
+   * Pins with the same frequency share a hardware timer, pins with different
+   * frequencies get a timer of their own, so they don't affect each other.
+   *
+   * @param[in] pin output pin for the PWM signal
+   * @param[in] duty_cycle duty cycle for the PWM signal (0-255)
+   * @param[in] frequency the frequency of the PWM signal in Hz
+   *****************************************************************************/
+  void duty_cycle_mode(PinName pin, int duty_cycle, int frequency);
+
+  /**************************************************************************//**
+   * Sets the duty cycle of multiple PWM channels at once
+   * All the new duty cycles of the pins sharing a frequency take effect
+   * at the start of the same PWM period.
+   *
+   * @param[in] pins output pins for the PWM signals
+   * @param[in] duty_cycles duty cycles for the PWM signals (0-255)
+   * @param[in] count the number of pins and duty cycles
+   *****************************************************************************/
+  void duty_cycle_mode(const PinName *pins, const int *duty_cycles, uint8_t count);
+
   /**************************************************************************//**
    * PWM signal generation in frequency mode
    * In this mode the duty cycle is fixed at 50% and the frequency
    * is variable by the user. Used for 'tone'.
-   * Can only handle one channel at a time.
+   * The pins in duty cycle mode are not affected by it.
    *
    * @param[in] pin output pin for the PWM signal
    * @param[in] frequency the desired frequency of the PWM signal
@@ -81,17 +113,39 @@ public:
 
   /***************************************************************************//**
    * Sets the write resolution in bits.
-   * The default is 8 bits, the maximum is 12 bits.
+   * The default is 8 bits, the maximum is 16 bits.
    *
    * @param[in] resolution the requested write resolution in bits
    ******************************************************************************/
   void duty_cycle_mode_set_write_resolution(uint8_t resolution);
 
+  /***************************************************************************//**
+   * Provides the effective resolution of the duty cycle at a PWM frequency.
+   * The duty cycle is programmed in timer counts, so the number of distinct
+   * steps depends on how many timer clock cycles fit into one period.
+   * Write resolutions above this value won't result in finer steps.
+   * The returned value is guaranteed on all timers - the 32-bit timers may
+   * provide more at low frequencies.
+   *
+   * @param[in] frequency the PWM frequency in Hz - the duty cycle mode frequency by default
+   *
+   * @return the effective resolution in bits - 0 if the frequency can't be generated
+   ******************************************************************************/
+  uint8_t duty_cycle_mode_get_effective_resolution(int frequency = duty_cycle_mode_default_freq);
+
+  /***************************************************************************//**
+   * Provides the effective resolution of the duty cycle on an active PWM pin.
+   *
+   * @param[in] pin the PWM pin
+   *
+   * @return the effective resolution in bits - 0 if the pin doesn't output PWM
+   ******************************************************************************/
+  uint8_t duty_cycle_mode_get_effective_resolution(PinName pin);
+
   /***************************************************************************//**
    * Turns the automatic deinitialization feature on or off.
-   * When it's on the PWM hardware will be deinitialized when 0 duty cycle is
-   * requested. If multiple channels are active, then this deinitialization will
-   * momentarily interrupt the other channels.
+   * When it's on the PWM output of a pin will be stopped when 0 duty cycle is
+   * requested. The other active channels are not affected by it.
    * When auto deinit is off PWM can still be stopped by calling stop() explicitly.
    * It's on by default. This setting is only relevant in duty cycle mode.
    *
@@ -99,24 +153,214 @@ public:
    ******************************************************************************/
   void set_auto_deinit(bool auto_deinit);
 
-private:
   /**************************************************************************//**
-   * Initializes PWM signal generation
+   * Plays a sequence of compare values on a PWM pin - one value in each PWM period
+   * The LDMA writes the values to the buffered compare register of the channel
+   * on every timer overflow, so the waveform is generated without any CPU involvement.
+   * The values are in timer counts - get_sequence_period() provides the
+   * number of counts in one period.
+   * The pin keeps its duty cycle mode frequency (1 kHz for new pins) and it's
+   * moved to another timer if needed, as sequences play on 16-bit timers and only
+   * one sequence can play on a timer at a time.
+   * The output keeps the last value of the sequence when it ends.
    *
    * @param[in] pin output pin for the PWM signal
-   * @param[in] frequency the desired frequency of the PWM signal
+   * @param[in] compares the compare values - they can be in flash and must stay valid while playing
+   * @param[in] len the number of values - at most LDMA_DESCRIPTOR_MAX_XFER_SIZE (2048)
+   * @param[in] repeat the number of times the sequence is played - 0 to loop it until stopped
+   * @param[in] callback called from interrupt context when the sequence has ended - can be nullptr
    *
-   * @return true if the initialization was successful, false otherwise
+   * @return SL_STATUS_OK if the sequence has started, an error code otherwise
+   *****************************************************************************/
+  sl_status_t play_sequence(PinName pin, const uint16_t *compares, uint32_t len, uint32_t repeat = 1u, void (*callback)(PinName pin) = nullptr);
+
+  /**************************************************************************//**
+   * Stops the sequence playing on a PWM pin
+   * The output keeps the last value written by the sequence.
+   *
+   * @param[in] pin the PWM pin playing the sequence
+   *****************************************************************************/
+  void stop_sequence(PinName pin);
+
+  /**************************************************************************//**
+   * Provides whether a sequence is playing on a PWM pin
+   *
+   * @param[in] pin the PWM pin
+   *
+   * @return true if a sequence is playing on the pin, false otherwise
    *****************************************************************************/
-  bool init(PinName pin, int frequency);
+  bool is_sequence_playing(PinName pin);
 
+  /**************************************************************************//**
+   * Provides the length of a PWM period in timer counts for sequences
+   * A compare value of 0 in a sequence means 0%, this value means 100% duty cycle.
+   *
+   * @param[in] frequency the PWM frequency in Hz - the duty cycle mode frequency by default
+   *
+   * @return the number of timer counts in a period - 0 if the frequency can't be generated
+   *****************************************************************************/
+  uint32_t get_sequence_period(int frequency = duty_cycle_mode_default_freq);
+
+  /**************************************************************************//**
+   * Handles the end of a sequence pass - for internal use
+   *
+   * @param[in] timer_idx the index of the timer playing the sequence
+   *
+   * @return true if the sequence continues, false if it has ended
+   *****************************************************************************/
+  bool handle_sequence_pass_done(uint8_t timer_idx);
+
+private:
   enum pwm_mode_t {
     DUTY_CYCLE,
     FREQUENCY
   };
 
-  sl_pwm_config_t pwm_config;
-  pwm_mode_t pwm_mode;
+  /**************************************************************************//**
+   * Connects a pin to a timer channel running at the requested frequency
+   * Pins already running at the frequency are left as they are, others are
+   * moved to a timer with the frequency, starting a new one if needed.
+   * The PWM mutex has to be held.
+   *
+   * @param[in] pin output pin for the PWM signal
+   * @param[in] frequency the desired frequency of the PWM signal
+   * @param[in] mode the mode the pin is used in
+   * @param[in] for_sequence true if the pin needs a timer suitable for playing a sequence
+   *
+   * @return the index of the channel in 'pwm_pins' - UINT8_MAX if there are no free channels
+   *****************************************************************************/
+  uint8_t attach(PinName pin, int frequency, pwm_mode_t mode, bool for_sequence = false);
+
+  /**************************************************************************//**
+   * Disconnects a channel from its pin and stops its timer if it was the last user
+   * The PWM mutex has to be held.
+   *
+   * @param[in] pwm_channel_idx the index of the channel in 'pwm_pins'
+   *****************************************************************************/
+  void detach(uint8_t pwm_channel_idx);
+
+  /**************************************************************************//**
+   * Provides a timer running at the requested frequency with a free channel
+   * A new timer is started if none of the running ones can be shared.
+   *
+   * @param[in] frequency the desired frequency of the PWM signal
+   * @param[in] for_sequence true if the timer has to be suitable for playing a sequence
+   *
+   * @return the index of the timer in 'pwm_timers' - UINT8_MAX if no timers are available
+   *****************************************************************************/
+  uint8_t get_timer_for_frequency(int frequency, bool for_sequence);
+
+  /**************************************************************************//**
+   * Provides whether a timer can play a new sequence
+   *
+   * @param[in] timer_idx the index of the timer in 'pwm_timers'
+   *
+   * @return true if the timer has a 16-bit counter and no sequence playing, false otherwise
+   *****************************************************************************/
+  bool is_timer_suitable_for_sequence(uint8_t timer_idx);
+
+  /**************************************************************************//**
+   * Stops the sequence playing on a channel if there's any
+   *
+   * @param[in] pwm_channel_idx the index of the channel in 'pwm_pins'
+   *****************************************************************************/
+  void abort_sequence(uint8_t pwm_channel_idx);
+
+  /**************************************************************************//**
+   * Provides a free channel of a timer
+   *
+   * @param[in] timer_idx the index of the timer in 'pwm_timers'
+   *
+   * @return the free channel number - UINT8_MAX if all channels are in use
+   *****************************************************************************/
+  uint8_t get_free_cc_channel(uint8_t timer_idx);
+
+  /**************************************************************************//**
+   * Starts a timer with all of its channels in PWM mode
+   * The channels are configured upfront, because their configuration can only
+   * be changed while the timer is stopped.
+   *
+   * @param[in] timer_idx the index of the timer in 'pwm_timers'
+   * @param[in] frequency the desired frequency of the PWM signal
+   * @param[in] max_counter_bits the widest timer counter accepted
+   *
+   * @return true if the initialization was successful, false otherwise
+   *****************************************************************************/
+  bool init_timer(uint8_t timer_idx, int frequency, uint8_t max_counter_bits);
+
+  /**************************************************************************//**
+   * Stops a timer and releases it
+   *
+   * @param[in] timer_idx the index of the timer in 'pwm_timers'
+   *****************************************************************************/
+  void deinit_timer(uint8_t timer_idx);
+
+  /**************************************************************************//**
+   * Calculates the timer period for a PWM frequency
+   *
+   * @param[in] clock_freq the frequency of the timer clock
+   * @param[in] max_count the largest value of the timer counter
+   * @param[in] frequency the desired frequency of the PWM signal
+   * @param[out] prescale the timer clock divider needed for the frequency
+   * @param[out] top the timer top value needed for the frequency
+   *
+   * @return true if the frequency can be generated, false otherwise
+   *****************************************************************************/
+  bool calculate_timer_period(uint32_t clock_freq, uint32_t max_count, int frequency, uint32_t *prescale, uint32_t *top);
+
+  /**************************************************************************//**
+   * Calculates the number of duty cycle bits a timer period provides
+   *
+   * @param[in] top the timer top value
+   *
+   * @return the resolution in bits
+   *****************************************************************************/
+  uint8_t get_resolution_for_top(uint32_t top);
+
+  /**************************************************************************//**
+   * Calculates the compare value of a duty cycle at the full timer resolution
+   *
+   * @param[in] timer_idx the index of the timer in 'pwm_timers'
+   * @param[in] duty_cycle the duty cycle as a fraction of 'max_value'
+   * @param[in] max_value the value corresponding to 100% duty cycle
+   *
+   * @return the compare value for the period of the timer
+   *****************************************************************************/
+  uint32_t get_compare_value(uint8_t timer_idx, uint32_t duty_cycle, uint32_t max_value);
+
+  /**************************************************************************//**
+   * Prepares a new duty cycle for a channel without writing it to the timer
+   * The PWM mutex has to be held.
+   *
+   * @param[in] pin output pin for the PWM signal
+   * @param[in] duty_cycle duty cycle for the PWM signal
+   * @param[in] frequency the frequency of the PWM signal - 0 to keep the current one
+   * @param[out] compare_value the compare value to be written to the channel
+   *
+   * @return the index of the channel in 'pwm_pins' - UINT8_MAX if there's nothing to write
+   *****************************************************************************/
+  uint8_t prepare_duty_cycle(PinName pin, int duty_cycle, int frequency, uint32_t *compare_value);
+
+  /**************************************************************************//**
+   * Writes the buffered compare registers of multiple channels so the
+   * channels of each timer latch at the same timer overflow
+   *
+   * @param[in] pwm_channel_idxs the indexes of the channels in 'pwm_pins'
+   * @param[in] compare_values the compare values to be written
+   * @param[in] count the number of channels
+   *****************************************************************************/
+  void write_compare_values(const uint8_t *pwm_channel_idxs, const uint32_t *compare_values, uint8_t count);
+
+  /**************************************************************************//**
+   * Sets the duty cycle of multiple channels - the PWM mutex has to be held
+   *
+   * @param[in] pins output pins for the PWM signals
+   * @param[in] duty_cycles duty cycles for the PWM signals
+   * @param[in] count the number of pins and duty cycles
+   * @param[in] frequency the frequency of the PWM signals - 0 to keep the current ones
+   *****************************************************************************/
+  void set_duty_cycles(const PinName *pins, const int *duty_cycles, uint8_t count, int frequency);
+
   bool auto_deinit;
 
   static const int duty_cycle_mode_default_freq = 1000;
@@ -124,23 +368,59 @@ private:
   SemaphoreHandle_t pwm_mutex;
   StaticSemaphore_t pwm_mutex_buf;
 
-  static const uint8_t max_pwm_channels = 3u;
-  static const uint32_t pwm_stabilization_time_ms = 2u;
+  static const uint8_t max_pwm_timers = TIMER_COUNT;
+  static const uint8_t cc_channels_per_timer = TIMER0_CC_NUM;
+  static const uint8_t max_pwm_channels = max_pwm_timers * cc_channels_per_timer;
+  // The largest prescaler of the timer clock
+  static const uint32_t max_timer_prescale = 1024u;
+  // The CPU cycles needed to write all the buffered compare registers with interrupts disabled
+  static const uint32_t compare_write_cpu_cycles = 64u;
+  // The smallest counter of the timers - used for the guaranteed resolution
+  static const uint32_t min_timer_max_count = 0xFFFFu;
 
-  uint32_t duty_cycle_set_time;
+  typedef struct {
+    TIMER_TypeDef* timer;
+    CMU_Clock_TypeDef clock;
+    int frequency;
+    uint32_t prescale;
+    uint32_t top;
+  } pwm_timer_t;
+
+  pwm_timer_t pwm_timers[max_pwm_timers];
 
   uint8_t duty_cycle_mode_write_resolution;
   uint32_t duty_cycle_mode_max_value;
-  static const uint8_t duty_cycle_mode_write_resolution_max = 12u;
+  static const uint8_t duty_cycle_mode_write_resolution_max = 16u;
+
+  // Marks the compare value of a channel which hasn't been set yet
+  static const uint32_t compare_value_unset = UINT32_MAX;
 
   typedef struct {
     PinName pin;
-    uint8_t duty_cycle_percent;
-    sl_pwm_instance_t inst;
+    pwm_mode_t mode;
+    uint32_t compare_value;
+    uint8_t timer_idx;
+    uint8_t cc_channel;
   } pwm_pin_t;
 
   pwm_pin_t pwm_pins[max_pwm_channels];
 
+  // The LDMA writes the compare values in 16-bit units - the sequences play on 16-bit timers
+  static const uint8_t sequence_timer_counter_bits = 16u;
+
+  typedef struct {
+    bool active;
+    uint8_t pwm_channel_idx;
+    unsigned int dma_channel;
+    LDMA_Descriptor_t descriptor;
+    uint32_t repeat;
+    uint32_t passes_done;
+    void (*callback)(PinName pin);
+  } pwm_sequence_t;
+
+  // One sequence for each timer - the LDMA request of the timer overflow can serve only one channel
+  pwm_sequence_t pwm_sequences[max_pwm_timers];
+
   /**************************************************************************//**
    * Provides the next free PWM channel index if available
    *
@@ -159,16 +439,13 @@ private:
   uint8_t get_pwm_channel_idx_for_pin(PinName pin);
 
   /**************************************************************************//**
-   * Provides the number of PWM channels in use
+   * Provides the number of PWM channels using a timer
    *
-   * @return the number of PWM channels in use
-   *****************************************************************************/
-  uint8_t get_num_of_pwm_channels_in_use();
-
-  /**************************************************************************//**
-   * Deinitializes all active PWM channels
+   * @param[in] timer_idx the index of the timer in 'pwm_timers'
+   *
+   * @return the number of PWM channels using the timer
    *****************************************************************************/
-  void deinit_all_pwm_channels();
+  uint8_t get_num_of_pwm_channels_on_timer(uint8_t timer_idx);
 };
 } // namespace arduino
 
@@ -0,0 +1,224 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "timer_allocator.h"
+
+using namespace arduino;
+
+TIMER_TypeDef* const TimerAllocatorClass::timers[] = {
+  #if defined(TIMER0)
+  TIMER0,
+  #endif // TIMER0
+  #if defined(TIMER1)
+  TIMER1,
+  #endif // TIMER1
+  #if defined(TIMER2)
+  TIMER2,
+  #endif // TIMER2
+  #if defined(TIMER3)
+  TIMER3,
+  #endif // TIMER3
+  #if defined(TIMER4)
+  TIMER4,
+  #endif // TIMER4
+};
+
+const uint8_t TimerAllocatorClass::num_of_timers = sizeof(TimerAllocatorClass::timers) / sizeof(TimerAllocatorClass::timers[0]);
+
+TimerAllocatorClass::TimerAllocatorClass() :
+  claimed_timers(0u)
+{
+  ;
+}
+
+TIMER_TypeDef* TimerAllocatorClass::allocate(uint8_t max_counter_bits)
+{
+  TIMER_TypeDef* timer = nullptr;
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  for (uint8_t i = 0; i < this->num_of_timers; i++) {
+    if (TIMER_CNTWIDTH(TIMER_NUM(this->timers[i])) > max_counter_bits) {
+      continue;
+    }
+    if ((this->claimed_timers & (1u << i)) == 0u) {
+      this->claimed_timers |= (1u << i);
+      timer = this->timers[i];
+      break;
+    }
+  }
+  CORE_EXIT_ATOMIC();
+  return timer;
+}
+
+bool TimerAllocatorClass::claim(TIMER_TypeDef* timer)
+{
+  uint8_t timer_idx = get_timer_idx(timer);
+  if (timer_idx == UINT8_MAX) {
+    return false;
+  }
+
+  bool claimed = false;
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  if ((this->claimed_timers & (1u << timer_idx)) == 0u) {
+    this->claimed_timers |= (1u << timer_idx);
+    claimed = true;
+  }
+  CORE_EXIT_ATOMIC();
+  return claimed;
+}
+
+void TimerAllocatorClass::release(TIMER_TypeDef* timer)
+{
+  uint8_t timer_idx = get_timer_idx(timer);
+  if (timer_idx == UINT8_MAX) {
+    return;
+  }
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  this->claimed_timers &= ~(1u << timer_idx);
+  CORE_EXIT_ATOMIC();
+}
+
+bool TimerAllocatorClass::is_claimed(TIMER_TypeDef* timer)
+{
+  uint8_t timer_idx = get_timer_idx(timer);
+  if (timer_idx == UINT8_MAX) {
+    return false;
+  }
+  return (this->claimed_timers & (1u << timer_idx)) != 0u;
+}
+
+bool TimerAllocatorClass::get_clock(TIMER_TypeDef* timer, CMU_Clock_TypeDef* clock)
+{
+  #if defined(TIMER0)
+  if (timer == TIMER0) {
+    *clock = cmuClock_TIMER0;
+    return true;
+  }
+  #endif // TIMER0
+  #if defined(TIMER1)
+  if (timer == TIMER1) {
+    *clock = cmuClock_TIMER1;
+    return true;
+  }
+  #endif // TIMER1
+  #if defined(TIMER2)
+  if (timer == TIMER2) {
+    *clock = cmuClock_TIMER2;
+    return true;
+  }
+  #endif // TIMER2
+  #if defined(TIMER3)
+  if (timer == TIMER3) {
+    *clock = cmuClock_TIMER3;
+    return true;
+  }
+  #endif // TIMER3
+  #if defined(TIMER4)
+  if (timer == TIMER4) {
+    *clock = cmuClock_TIMER4;
+    return true;
+  }
+  #endif // TIMER4
+  return false;
+}
+
+bool TimerAllocatorClass::get_overflow_dma_signal(TIMER_TypeDef* timer, LDMA_PeripheralSignal_t* signal)
+{
+  #if defined(TIMER0)
+  if (timer == TIMER0) {
+    *signal = ldmaPeripheralSignal_TIMER0_UFOF;
+    return true;
+  }
+  #endif // TIMER0
+  #if defined(TIMER1)
+  if (timer == TIMER1) {
+    *signal = ldmaPeripheralSignal_TIMER1_UFOF;
+    return true;
+  }
+  #endif // TIMER1
+  #if defined(TIMER2)
+  if (timer == TIMER2) {
+    *signal = ldmaPeripheralSignal_TIMER2_UFOF;
+    return true;
+  }
+  #endif // TIMER2
+  #if defined(TIMER3)
+  if (timer == TIMER3) {
+    *signal = ldmaPeripheralSignal_TIMER3_UFOF;
+    return true;
+  }
+  #endif // TIMER3
+  #if defined(TIMER4)
+  if (timer == TIMER4) {
+    *signal = ldmaPeripheralSignal_TIMER4_UFOF;
+    return true;
+  }
+  #endif // TIMER4
+  return false;
+}
+
+bool TimerAllocatorClass::get_cc_dma_signal(TIMER_TypeDef* timer, uint8_t cc_channel, LDMA_PeripheralSignal_t* signal)
+{
+  // The rows follow the order of 'timers'
+  static const LDMA_PeripheralSignal_t cc_signals[][3] = {
+    #if defined(TIMER0)
+    { ldmaPeripheralSignal_TIMER0_CC0, ldmaPeripheralSignal_TIMER0_CC1, ldmaPeripheralSignal_TIMER0_CC2 },
+    #endif // TIMER0
+    #if defined(TIMER1)
+    { ldmaPeripheralSignal_TIMER1_CC0, ldmaPeripheralSignal_TIMER1_CC1, ldmaPeripheralSignal_TIMER1_CC2 },
+    #endif // TIMER1
+    #if defined(TIMER2)
+    { ldmaPeripheralSignal_TIMER2_CC0, ldmaPeripheralSignal_TIMER2_CC1, ldmaPeripheralSignal_TIMER2_CC2 },
+    #endif // TIMER2
+    #if defined(TIMER3)
+    { ldmaPeripheralSignal_TIMER3_CC0, ldmaPeripheralSignal_TIMER3_CC1, ldmaPeripheralSignal_TIMER3_CC2 },
+    #endif // TIMER3
+    #if defined(TIMER4)
+    { ldmaPeripheralSignal_TIMER4_CC0, ldmaPeripheralSignal_TIMER4_CC1, ldmaPeripheralSignal_TIMER4_CC2 },
+    #endif // TIMER4
+  };
+
+  uint8_t timer_idx = get_timer_idx(timer);
+  if (timer_idx >= num_of_timers || cc_channel >= 3u) {
+    return false;
+  }
+  *signal = cc_signals[timer_idx][cc_channel];
+  return true;
+}
+
+uint8_t TimerAllocatorClass::get_timer_idx(TIMER_TypeDef* timer)
+{
+  for (uint8_t i = 0; i < num_of_timers; i++) {
+    if (timers[i] == timer) {
+      return i;
+    }
+  }
+  return UINT8_MAX;
+}
+
+arduino::TimerAllocatorClass TimerAllocator;
@@ -0,0 +1,133 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2024 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Arduino.h"
+
+#ifndef __ARDUINO_TIMER_ALLOCATOR_H
+#define __ARDUINO_TIMER_ALLOCATOR_H
+
+#include <inttypes.h>
+#include "em_cmu.h"
+#include "em_core.h"
+#include "em_ldma.h"
+#include "em_timer.h"
+
+namespace arduino {
+class TimerAllocatorClass {
+public:
+  /***************************************************************************//**
+   * Constructor for TimerAllocatorClass
+   ******************************************************************************/
+  TimerAllocatorClass();
+
+  /***************************************************************************//**
+   * Claims the first free TIMER peripheral
+   * The timers are handed out in ascending order - TIMER0 and TIMER1 have
+   * 32-bit counters, the others are 16-bit.
+   *
+   * @param[in] max_counter_bits the widest counter accepted - 32 bits by default
+   *
+   * @return the claimed timer - nullptr if all of them are in use
+   ******************************************************************************/
+  TIMER_TypeDef* allocate(uint8_t max_counter_bits = 32u);
+
+  /***************************************************************************//**
+   * Claims a specific TIMER peripheral
+   *
+   * @param[in] timer the timer to claim
+   *
+   * @return true if the timer was claimed, false if it's already in use or not available
+   ******************************************************************************/
+  bool claim(TIMER_TypeDef* timer);
+
+  /***************************************************************************//**
+   * Releases a previously claimed TIMER peripheral
+   *
+   * @param[in] timer the timer to release
+   ******************************************************************************/
+  void release(TIMER_TypeDef* timer);
+
+  /***************************************************************************//**
+   * Provides whether a TIMER peripheral is claimed
+   *
+   * @param[in] timer the timer to check
+   *
+   * @return true if the timer is in use, false otherwise
+   ******************************************************************************/
+  bool is_claimed(TIMER_TypeDef* timer);
+
+  /***************************************************************************//**
+   * Provides the clock of a TIMER peripheral
+   *
+   * @param[in] timer the timer to get the clock for
+   * @param[out] clock the clock of the timer
+   *
+   * @return true if the timer is available on the device, false otherwise
+   ******************************************************************************/
+  static bool get_clock(TIMER_TypeDef* timer, CMU_Clock_TypeDef* clock);
+
+  /***************************************************************************//**
+   * Provides the LDMA request signal of a TIMER peripheral's overflow
+   *
+   * @param[in] timer the timer to get the signal for
+   * @param[out] signal the overflow signal of the timer
+   *
+   * @return true if the timer is available on the device, false otherwise
+   ******************************************************************************/
+  static bool get_overflow_dma_signal(TIMER_TypeDef* timer, LDMA_PeripheralSignal_t* signal);
+
+  /***************************************************************************//**
+   * Provides the LDMA request signal of a TIMER peripheral's compare/capture channel
+   *
+   * @param[in] timer the timer to get the signal for
+   * @param[in] cc_channel the compare/capture channel of the timer
+   * @param[out] signal the compare/capture signal of the channel
+   *
+   * @return true if the channel is available on the device, false otherwise
+   ******************************************************************************/
+  static bool get_cc_dma_signal(TIMER_TypeDef* timer, uint8_t cc_channel, LDMA_PeripheralSignal_t* signal);
+
+private:
+  /***************************************************************************//**
+   * Provides the index of a TIMER peripheral in 'timers'
+   *
+   * @param[in] timer the timer to get the index for
+   *
+   * @return the index of the timer - UINT8_MAX if it's not available
+   ******************************************************************************/
+  static uint8_t get_timer_idx(TIMER_TypeDef* timer);
+
+  static TIMER_TypeDef* const timers[];
+  static const uint8_t num_of_timers;
+
+  // One bit for each claimed timer in 'timers'
+  uint32_t claimed_timers;
+};
+} // namespace arduino
+
+extern arduino::TimerAllocatorClass TimerAllocator;
+
+#endif // __ARDUINO_TIMER_ALLOCATOR_H
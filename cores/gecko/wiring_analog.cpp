@@ -42,27 +42,171 @@ int analogRead(PinName pin)
   return (int)ADC.get_sample(pin);
 }
 
+int analogReadMillivolts(pin_size_t pin)
+{
+  PinName pin_name = pinToPinName(pin);
+  if (pin_name == PIN_NAME_NC) {
+    return 0;
+  }
+  return analogReadMillivolts(pin_name);
+}
+
+int analogReadMillivolts(PinName pin)
+{
+  return (int)ADC.get_millivolts(pin);
+}
+
+int analogReadDifferential(pin_size_t positive_pin, pin_size_t negative_pin, uint8_t gain)
+{
+  return analogReadDifferential(pinToPinName(positive_pin), pinToPinName(negative_pin), gain);
+}
+
+int analogReadDifferential(PinName positive_pin, PinName negative_pin, uint8_t gain)
+{
+  return (int)ADC.get_differential_sample(positive_pin, negative_pin, gain);
+}
+
+int analogReadDifferentialMillivolts(pin_size_t positive_pin, pin_size_t negative_pin, uint8_t gain)
+{
+  return analogReadDifferentialMillivolts(pinToPinName(positive_pin), pinToPinName(negative_pin), gain);
+}
+
+int analogReadDifferentialMillivolts(PinName positive_pin, PinName negative_pin, uint8_t gain)
+{
+  return (int)ADC.get_differential_millivolts(positive_pin, negative_pin, gain);
+}
+
 void analogReference(uint8_t reference)
 {
   ADC.set_reference(reference);
 }
 
-void analogReadDMA(PinName pin, uint32_t *buffer, uint32_t size, void (*user_onsampling_finished_callback)())
+void analogReferenceUpdate()
+{
+  ADC.update_supply_voltage();
+}
+
+// Converts an array of Arduino pin numbers to pin names, returns false if any of them is invalid
+static bool pins_to_pin_names(const pin_size_t *pins, uint8_t num_pins, PinName *pin_names)
+{
+  if (!pins || num_pins > AdcClass::max_scan_pins) {
+    return false;
+  }
+  for (uint8_t i = 0u; i < num_pins; i++) {
+    pin_names[i] = pinToPinName(pins[i]);
+    if (pin_names[i] == PIN_NAME_NC) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Starts or stops the DMA sampling with either 32-bit or 16-bit sample buffers
+template <typename sample_t>
+static float analog_read_dma(const PinName *pins, uint8_t num_pins, sample_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)())
+{
+  if (!user_onsampling_finished_callback) {
+    ADC.scan_stop();
+    return 0.0f;
+  }
+  if (ADC.scan_start(pins, num_pins, buffer, size, sample_rate_hz, user_onsampling_finished_callback) != SL_STATUS_OK) {
+    return 0.0f;
+  }
+  return ADC.get_scan_sample_rate();
+}
+
+template <typename sample_t>
+static void analog_read_dma(PinName pin, sample_t *buffer, uint32_t size, void (*user_onsampling_finished_callback)())
 {
-  if(user_onsampling_finished_callback) {
+  if (user_onsampling_finished_callback) {
     ADC.scan_start(pin, buffer, size, user_onsampling_finished_callback);
   } else {
     ADC.scan_stop();
   }
 }
 
+void analogReadDMA(PinName pin, uint32_t *buffer, uint32_t size, void (*user_onsampling_finished_callback)())
+{
+  analog_read_dma(pin, buffer, size, user_onsampling_finished_callback);
+}
+
 void analogReadDMA(pin_size_t pin, uint32_t *buffer, uint32_t size, void (*user_onsampling_finished_callback)())
 {
   PinName pin_name = pinToPinName(pin);
   if (pin_name == PIN_NAME_NC) {
     return;
   }
-  analogReadDMA(pin_name, buffer, size, user_onsampling_finished_callback);
+  analog_read_dma(pin_name, buffer, size, user_onsampling_finished_callback);
+}
+
+void analogReadDMA(PinName pin, uint16_t *buffer, uint32_t size, void (*user_onsampling_finished_callback)())
+{
+  analog_read_dma(pin, buffer, size, user_onsampling_finished_callback);
+}
+
+void analogReadDMA(pin_size_t pin, uint16_t *buffer, uint32_t size, void (*user_onsampling_finished_callback)())
+{
+  PinName pin_name = pinToPinName(pin);
+  if (pin_name == PIN_NAME_NC) {
+    return;
+  }
+  analog_read_dma(pin_name, buffer, size, user_onsampling_finished_callback);
+}
+
+float analogReadDMA(PinName pin, uint32_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)())
+{
+  return analog_read_dma(&pin, 1u, buffer, size, sample_rate_hz, user_onsampling_finished_callback);
+}
+
+float analogReadDMA(pin_size_t pin, uint32_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)())
+{
+  PinName pin_name = pinToPinName(pin);
+  if (pin_name == PIN_NAME_NC) {
+    return 0.0f;
+  }
+  return analog_read_dma(&pin_name, 1u, buffer, size, sample_rate_hz, user_onsampling_finished_callback);
+}
+
+float analogReadDMA(PinName pin, uint16_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)())
+{
+  return analog_read_dma(&pin, 1u, buffer, size, sample_rate_hz, user_onsampling_finished_callback);
+}
+
+float analogReadDMA(pin_size_t pin, uint16_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)())
+{
+  PinName pin_name = pinToPinName(pin);
+  if (pin_name == PIN_NAME_NC) {
+    return 0.0f;
+  }
+  return analog_read_dma(&pin_name, 1u, buffer, size, sample_rate_hz, user_onsampling_finished_callback);
+}
+
+float analogReadDMA(const PinName *pins, uint8_t num_pins, uint32_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)())
+{
+  return analog_read_dma(pins, num_pins, buffer, size, sample_rate_hz, user_onsampling_finished_callback);
+}
+
+float analogReadDMA(const pin_size_t *pins, uint8_t num_pins, uint32_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)())
+{
+  PinName pin_names[AdcClass::max_scan_pins];
+  if (!pins_to_pin_names(pins, num_pins, pin_names)) {
+    return 0.0f;
+  }
+  return analog_read_dma(pin_names, num_pins, buffer, size, sample_rate_hz, user_onsampling_finished_callback);
+}
+
+float analogReadDMA(const PinName *pins, uint8_t num_pins, uint16_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)())
+{
+  return analog_read_dma(pins, num_pins, buffer, size, sample_rate_hz, user_onsampling_finished_callback);
+}
+
+float analogReadDMA(const pin_size_t *pins, uint8_t num_pins, uint16_t *buffer, uint32_t size, uint32_t sample_rate_hz, void (*user_onsampling_finished_callback)())
+{
+  PinName pin_names[AdcClass::max_scan_pins];
+  if (!pins_to_pin_names(pins, num_pins, pin_names)) {
+    return 0.0f;
+  }
+  return analog_read_dma(pin_names, num_pins, buffer, size, sample_rate_hz, user_onsampling_finished_callback);
 }
 
 void analogReferenceDAC(uint8_t reference)
@@ -153,3 +297,11 @@ void analogReadResolution(int resolution)
 {
   ADC.set_read_resolution((uint8_t)resolution);
 }
+
+void analogReadAveraging(int samples)
+{
+  if (samples < 1) {
+    samples = 1;
+  }
+  ADC.set_read_averaging((uint8_t)min(samples, 255));
+}
@@ -26,20 +26,73 @@
 
 #include "SPI.h"
 #include "arduino_spi_config.h"
+#if defined(USART_PRESENT)
+  #include "em_usart.h"
+#endif
+#if defined(EUSART_PRESENT)
+  #include "em_eusart.h"
+#endif
+#include "gpiointerrupt.h"
+#if defined(SL_CATALOG_POWER_MANAGER_PRESENT)
+  #include "sl_power_manager.h"
+#endif
 
 using namespace arduino;
 
-SilabsSPI::SilabsSPI(SPIDRV_Handle_t sl_spidrv_handle, SPIDRV_Init_t* sl_spidrv_config, SPIDRV_Callback_t dma_transfer_finished_callback) :
-  initialized(false)
+static bool transferv_dma_finished_cb(unsigned int channel, unsigned int sequenceNo, void *userParam)
+{
+  (void)channel;
+  (void)sequenceNo;
+  ((SilabsSPI*)userParam)->dma_transfer_finished_cb(nullptr, ECODE_EMDRV_SPIDRV_OK, 0);
+  return true;
+}
+
+static void follower_cs_irq_handler(uint8_t intNo, void *ctx)
+{
+  (void)intNo;
+  ((SilabsSPI*)ctx)->follower_cs_released_cb();
+}
+
+static uint32_t round_to_khz(uint32_t freq)
+{
+  return ((freq + 500u) / 1000u) * 1000u;
+}
+
+SilabsSPI::SilabsSPI(SPIDRV_Handle_t sl_spidrv_handle, SPIDRV_Init_t* sl_spidrv_config, SPIDRV_Callback_t dma_transfer_finished_callback, SPIDRV_Callback_t async_transfer_finished_callback) :
+  initialized(false),
+  settings_valid(false),
+  peripheral_clock_freq(0u),
+  active_clock_config(0u),
+  active_frame_config(0u),
+  dma_threshold(DEFAULT_DMA_THRESHOLD),
+  transaction_owner(nullptr),
+  transferv_dummy_tx(0u),
+  transferv_dummy_rx(0u),
+  follower_mode(false),
+  follower_cs_pin(PIN_NAME_NC),
+  follower_cs_interrupt(INTERRUPT_UNAVAILABLE),
+  follower_tx_buf(nullptr),
+  follower_tx_len(0u),
+  follower_rx_buf(nullptr),
+  follower_rx_len(0u),
+  follower_callback(nullptr),
+  follower_callback_user_data(nullptr),
+  async_queue_head(0u),
+  async_queue_len(0u),
+  async_current_job(nullptr),
+  async_paused(false)
 {
   this->sl_spidrv_handle = sl_spidrv_handle;
   this->sl_spidrv_config = sl_spidrv_config;
   this->dma_transfer_finished_callback = dma_transfer_finished_callback;
+  this->async_transfer_finished_callback = async_transfer_finished_callback;
 
   this->spi_transfer_mutex = xSemaphoreCreateMutexStatic(&this->spi_transfer_mutex_buf);
   configASSERT(this->spi_transfer_mutex);
   this->spi_busy_mutex = xSemaphoreCreateMutexStatic(&this->spi_busy_mutex_buf);
   configASSERT(this->spi_busy_mutex);
+  this->async_idle_sem = xSemaphoreCreateBinaryStatic(&this->async_idle_sem_buf);
+  configASSERT(this->async_idle_sem);
 }
 
 void SilabsSPI::begin()
@@ -50,60 +103,328 @@ void SilabsSPI::begin()
   sl_status_t sc = SPIDRV_Init(this->sl_spidrv_handle, this->sl_spidrv_config);
   if (sc == SL_STATUS_OK) {
     this->initialized = true;
+    // The driver configured the peripheral from the config - the transactions change the registers directly from now on
+    this->update_peripheral_clock_freq();
+    this->settings_valid = false;
   }
 }
 
 void SilabsSPI::beginTransaction(SPISettings settings)
 {
   xSemaphoreTake(this->spi_busy_mutex, portMAX_DELAY);
+  // The bus lock is held until endTransaction()
+  this->transaction_owner = xTaskGetCurrentTaskHandle();
+  this->pause_async_jobs();
+  this->apply_settings(settings);
+}
+
+void SilabsSPI::beginTransaction(const spi_profile_t& profile)
+{
+  xSemaphoreTake(this->spi_busy_mutex, portMAX_DELAY);
+  // The bus lock is held until endTransaction()
+  this->transaction_owner = xTaskGetCurrentTaskHandle();
+  this->pause_async_jobs();
+  if (this->settings_valid && this->settings == profile.settings) {
+    return;
+  }
+  this->apply_profile(profile);
+}
+
+void SilabsSPI::apply_settings(SPISettings settings)
+{
   // Don't do anything if the settings don't change
-  if (this->settings.getClockFreq() == settings.getClockFreq()
-      && this->settings.getBitOrder() == settings.getBitOrder()
-      && this->settings.getDataMode() == settings.getDataMode()) {
+  if (this->settings_valid && this->settings == settings) {
     return;
   }
-  // Deinit the peripheral
-  SPIDRV_DeInit(this->sl_spidrv_handle);
-  // Apply the new settings
-  this->sl_spidrv_config->bitRate = settings.getClockFreq();
+  this->apply_profile(this->createProfile(settings));
+}
+
+spi_profile_t SilabsSPI::createProfile(SPISettings settings)
+{
+  spi_profile_t profile;
+  profile.settings = settings;
+  profile.peripheral_clock_freq = this->peripheral_clock_freq;
+  profile.clock_config = 0u;
+  profile.frame_config = 0u;
+
+  uint32_t bitrate = settings.getClockFreq();
+  // A zero clock can't be divided down to - use the slowest clock the divider allows instead
+  if (bitrate == 0u) {
+    bitrate = 1u;
+  }
+  // The registers can only be calculated once the peripheral clock is known after begin()
+  if (this->peripheral_clock_freq == 0u) {
+    profile.peripheral_clock_freq = 0u;
+    return profile;
+  }
+
+  SPIMode data_mode = settings.getDataMode();
+  bool clock_polarity = (data_mode == SPI_MODE2 || data_mode == SPI_MODE3);
+  bool clock_phase = (data_mode == SPI_MODE1 || data_mode == SPI_MODE3);
+  bool msb_first = (settings.getBitOrder() == MSBFIRST);
+
+  #if defined(EUSART_PRESENT)
+  if (this->is_eusart()) {
+    // bitrate = clock / (SDIV + 1) - round the divider up to never exceed the requested speed
+    uint32_t sdiv = (this->peripheral_clock_freq + bitrate - 1u) / bitrate;
+    sdiv = (sdiv > 0u) ? sdiv - 1u : 0u;
+    if (sdiv > (_EUSART_CFG2_SDIV_MASK >> _EUSART_CFG2_SDIV_SHIFT)) {
+      sdiv = _EUSART_CFG2_SDIV_MASK >> _EUSART_CFG2_SDIV_SHIFT;
+    }
+    profile.clock_config = (sdiv << _EUSART_CFG2_SDIV_SHIFT)
+                           | (clock_polarity ? EUSART_CFG2_CLKPOL : 0u)
+                           | (clock_phase ? EUSART_CFG2_CLKPHA : 0u);
+    profile.frame_config = msb_first ? EUSART_CFG0_MSBF : 0u;
+    return profile;
+  }
+  #endif // EUSART_PRESENT
+
+  #if defined(USART_PRESENT)
+  // bitrate = clock / (2 * (DIV + 1)) - the integer part of the divider starts at bit 8
+  uint32_t div = (this->peripheral_clock_freq + (2u * bitrate) - 1u) / (2u * bitrate);
+  div = (div > 0u) ? div - 1u : 0u;
+  if (div > (_USART_CLKDIV_DIV_MASK >> 8u)) {
+    div = _USART_CLKDIV_DIV_MASK >> 8u;
+  }
+  profile.clock_config = div << 8u;
+  profile.frame_config = (clock_polarity ? USART_CTRL_CLKPOL : 0u)
+                         | (clock_phase ? USART_CTRL_CLKPHA : 0u)
+                         | (msb_first ? USART_CTRL_MSBF : 0u);
+  #endif // USART_PRESENT
+  return profile;
+}
+
+void SilabsSPI::apply_profile(const spi_profile_t& profile)
+{
+  // Pick up the clock tree changes before the registers are calculated
+  if (this->initialized) {
+    this->update_peripheral_clock_freq();
+  }
+  this->write_profile(profile);
+}
+
+// Only calculates and writes the registers with the last known peripheral clock - no RTOS or clock tree calls,
+// so the async jobs can switch between the devices from the DMA interrupt
+void SilabsSPI::write_profile(const spi_profile_t& profile)
+{
+  SPISettings settings = profile.settings;
+  // Keep the driver config in sync - it's used when the peripheral is initialized again
+  // The driver can't divide down to a zero clock either, so it gets the slowest one
+  this->sl_spidrv_config->bitRate = (settings.getClockFreq() > 0u) ? settings.getClockFreq() : 1u;
   setBitOrder(settings.getBitOrder());
   setDataMode(settings.getDataMode());
-  // Reinit the peripheral
-  SPIDRV_Init(this->sl_spidrv_handle, this->sl_spidrv_config);
+  this->sl_spidrv_handle->initData.bitRate = this->sl_spidrv_config->bitRate;
+  this->sl_spidrv_handle->initData.bitOrder = this->sl_spidrv_config->bitOrder;
+  this->sl_spidrv_handle->initData.clockMode = this->sl_spidrv_config->clockMode;
+  this->settings = settings;
+  this->settings_valid = true;
+
+  if (!this->initialized) {
+    // begin() applies the new config
+    this->settings_valid = false;
+    return;
+  }
+
+  // Recalculate the profile once if it was created before the peripheral clock was known or the clock changed since
+  spi_profile_t recalculated_profile;
+  const spi_profile_t* active_profile = &profile;
+  if (profile.peripheral_clock_freq != this->peripheral_clock_freq) {
+    recalculated_profile = this->createProfile(settings);
+    active_profile = &recalculated_profile;
+  }
+  // Leave the registers alone if the peripheral clock still can't be determined
+  if (active_profile->peripheral_clock_freq == 0u) {
+    return;
+  }
+
+  // Switching between devices with the same configuration needs no register access
+  if (active_profile->clock_config == this->active_clock_config && active_profile->frame_config == this->active_frame_config) {
+    return;
+  }
+
+  #if defined(EUSART_PRESENT)
+  if (this->is_eusart()) {
+    EUSART_TypeDef *eusart = this->sl_spidrv_handle->peripheral.eusartPort;
+    // The configuration registers can only be written while the peripheral is disabled
+    // Disabling only waits a few peripheral clock cycles for the synchronization
+    EUSART_Enable(eusart, eusartDisable);
+    eusart->CFG0 = (eusart->CFG0 & ~EUSART_CFG0_MSBF) | active_profile->frame_config;
+    eusart->CFG2 = (eusart->CFG2 & ~(_EUSART_CFG2_SDIV_MASK | EUSART_CFG2_CLKPOL | EUSART_CFG2_CLKPHA)) | active_profile->clock_config;
+    EUSART_Enable(eusart, eusartEnable);
+  }
+  #endif // EUSART_PRESENT
+
+  #if defined(USART_PRESENT)
+  if (!this->is_eusart()) {
+    USART_TypeDef *usart = this->sl_spidrv_handle->peripheral.usartPort;
+    usart->CTRL = (usart->CTRL & ~(USART_CTRL_CLKPOL | USART_CTRL_CLKPHA | USART_CTRL_MSBF)) | active_profile->frame_config;
+    usart->CLKDIV = active_profile->clock_config;
+  }
+  #endif // USART_PRESENT
+
+  this->active_clock_config = active_profile->clock_config;
+  this->active_frame_config = active_profile->frame_config;
+}
+
+bool SilabsSPI::is_eusart()
+{
+  return this->sl_spidrv_handle->peripheralType == spidrvPeripheralTypeEusart;
+}
+
+void SilabsSPI::update_peripheral_clock_freq()
+{
+  // Derive the clock of the peripheral from the bitrate and the divider currently in use
+  // The bitrate is truncated by the division, so the result is rounded to kHz to be the same for every divider
+  #if defined(EUSART_PRESENT)
+  if (this->is_eusart()) {
+    EUSART_TypeDef *eusart = this->sl_spidrv_handle->peripheral.eusartPort;
+    uint32_t sdiv = (eusart->CFG2 & _EUSART_CFG2_SDIV_MASK) >> _EUSART_CFG2_SDIV_SHIFT;
+    this->peripheral_clock_freq = round_to_khz(EUSART_BaudrateGet(eusart) * (sdiv + 1u));
+    this->active_clock_config = eusart->CFG2 & (_EUSART_CFG2_SDIV_MASK | EUSART_CFG2_CLKPOL | EUSART_CFG2_CLKPHA);
+    this->active_frame_config = eusart->CFG0 & EUSART_CFG0_MSBF;
+    return;
+  }
+  #endif // EUSART_PRESENT
+
+  #if defined(USART_PRESENT)
+  USART_TypeDef *usart = this->sl_spidrv_handle->peripheral.usartPort;
+  uint32_t div = (usart->CLKDIV & _USART_CLKDIV_DIV_MASK) >> 8u;
+  this->peripheral_clock_freq = round_to_khz(USART_BaudrateGet(usart) * 2u * (div + 1u));
+  this->active_clock_config = usart->CLKDIV & _USART_CLKDIV_DIV_MASK;
+  this->active_frame_config = usart->CTRL & (USART_CTRL_CLKPOL | USART_CTRL_CLKPHA | USART_CTRL_MSBF);
+  #endif // USART_PRESENT
 }
 
 // Uses direct blocking transfers with the USART/EUSART driver
+// Frames wider than 8 bits are sent as one frame with the byte in the low bits
 uint8_t SilabsSPI::transfer(uint8_t data)
 {
+  if (this->sl_spidrv_config->frameLength > 8u) {
+    uint16_t tx_word = data;
+    uint16_t rx_word = 0u;
+    bool locked = this->lock_bus();
+    this->fifo_transfer((const uint8_t*)&tx_word, (uint8_t*)&rx_word, sizeof(tx_word));
+    this->unlock_bus(locked);
+    return (uint8_t)rx_word;
+  }
+
   uint8_t rx_byte = 0u;
-  xSemaphoreTake(this->spi_transfer_mutex, portMAX_DELAY);
+  bool locked = this->lock_bus();
   rx_byte = sl_spi_direct_transfer((void*)this->sl_spidrv_config->port, data);
-  xSemaphoreGive(this->spi_transfer_mutex);
+  this->unlock_bus(locked);
   return rx_byte;
 }
 
 // Uses direct blocking transfers with the USART/EUSART driver
+// Sends a single frame with frames wider than 8 bits - two 8 bit frames otherwise
 uint16_t SilabsSPI::transfer16(uint16_t data)
 {
+  if (this->sl_spidrv_config->frameLength > 8u) {
+    uint16_t rx_word = 0u;
+    bool locked = this->lock_bus();
+    this->fifo_transfer((const uint8_t*)&data, (uint8_t*)&rx_word, sizeof(data));
+    this->unlock_bus(locked);
+    return rx_word;
+  }
+
   uint16_t rx_bytes = 0u;
   uint8_t rx_data[2];
   uint8_t tx_data[2];
   tx_data[0] = (uint8_t)(data >> 8);
   tx_data[1] = (uint8_t)data;
-  rx_data[0] = this->transfer(tx_data[0]);
-  rx_data[1] = this->transfer(tx_data[1]);
+  bool locked = this->lock_bus();
+  rx_data[0] = sl_spi_direct_transfer((void*)this->sl_spidrv_config->port, tx_data[0]);
+  rx_data[1] = sl_spi_direct_transfer((void*)this->sl_spidrv_config->port, tx_data[1]);
+  this->unlock_bus(locked);
   rx_bytes = ((uint16_t)rx_data[0] << 8) + rx_data[1];
   return rx_bytes;
 }
 
-// Uses DMA and waits for the transaction to complete, has a large overhead for small amounts of data
+void SilabsSPI::transfer16(const uint16_t* tx_buf, uint16_t* rx_buf, size_t count)
+{
+  if ((!tx_buf && !rx_buf) || count == 0u) {
+    return;
+  }
+  // Keep the async jobs off the bus while the frame length differs from their one
+  bool locked = this->lock_bus();
+  // Switch to 16 bit frames for the transfer, so the words don't have to be split into bytes
+  uint8_t previous_frame_length = this->getFrameLength();
+  if (previous_frame_length != 16u && this->setFrameLength(16u) != SL_STATUS_OK) {
+    this->unlock_bus(locked);
+    return;
+  }
+  size_t byte_count = count * sizeof(uint16_t);
+  if (tx_buf && rx_buf) {
+    this->transfer((void*)tx_buf, (void*)rx_buf, byte_count, true);
+  } else if (tx_buf) {
+    this->transfer((void*)tx_buf, byte_count, true);
+  } else {
+    this->receive((void*)rx_buf, byte_count, true);
+  }
+  if (previous_frame_length != 16u) {
+    this->setFrameLength(previous_frame_length);
+  }
+  this->unlock_bus(locked);
+}
+
+sl_status_t SilabsSPI::setFrameLength(uint8_t bits)
+{
+  if (bits < 8u || bits > 16u) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  if (this->initialized) {
+    Ecode_t ecode = SPIDRV_SetFramelength(this->sl_spidrv_handle, bits);
+    if (ecode == ECODE_EMDRV_SPIDRV_BUSY) {
+      return SL_STATUS_BUSY;
+    } else if (ecode != ECODE_EMDRV_SPIDRV_OK) {
+      return SL_STATUS_FAIL;
+    }
+  }
+  // Keep the frame length for the next begin()
+  this->sl_spidrv_config->frameLength = bits;
+  return SL_STATUS_OK;
+}
+
+uint8_t SilabsSPI::getFrameLength()
+{
+  return (uint8_t)this->sl_spidrv_config->frameLength;
+}
+
+// The task owning the transaction already has the bus - every other transfer takes the bus lock
+// and lets the running async job finish, so the two never drive the peripheral at the same time
+bool SilabsSPI::lock_bus()
+{
+  if (this->transaction_owner == xTaskGetCurrentTaskHandle()) {
+    return false;
+  }
+  xSemaphoreTake(this->spi_busy_mutex, portMAX_DELAY);
+  // The nested transfers of the task see the bus as already locked
+  this->transaction_owner = xTaskGetCurrentTaskHandle();
+  this->pause_async_jobs();
+  return true;
+}
+
+void SilabsSPI::unlock_bus(bool locked)
+{
+  if (locked) {
+    this->resume_async_jobs();
+    this->transaction_owner = nullptr;
+    xSemaphoreGive(this->spi_busy_mutex);
+  }
+}
+
+// Small transfers poll the FIFO directly, larger ones use DMA
 void SilabsSPI::transfer(void* tx_buf, size_t count, bool block)
 {
-  if (block) {
+  bool locked = this->lock_bus();
+  if (count < this->dma_threshold) {
+    this->fifo_transfer((const uint8_t*)tx_buf, nullptr, count);
+  } else if (block) {
     this->_transfer_block(tx_buf, count);
   } else {
     this->_transfer_nonblock(tx_buf, count);
   }
+  this->unlock_bus(locked);
 }
 
 void SilabsSPI::transfer(void *buf, size_t count)
@@ -151,11 +472,15 @@ void SilabsSPI::_transfer_nonblock(void* tx_buf, size_t count)
 
 void SilabsSPI::transfer(void* tx_buf, void* rx_buf, size_t count, bool block)
 {
-  if (block) {
+  bool locked = this->lock_bus();
+  if (count < this->dma_threshold) {
+    this->fifo_transfer((const uint8_t*)tx_buf, (uint8_t*)rx_buf, count);
+  } else if (block) {
     this->_transfer_block(tx_buf, rx_buf, count);
   } else {
     this->_transfer_nonblock(tx_buf, rx_buf, count);
   }
+  this->unlock_bus(locked);
 }
 
 void SilabsSPI::_transfer_block(void* tx_buf, void* rx_buf, size_t count)
@@ -165,7 +490,7 @@ void SilabsSPI::_transfer_block(void* tx_buf, void* rx_buf, size_t count)
   while (bytes_transferred < count) {
     size_t current_transfer_size = get_next_dma_transfer_size(bytes_transferred, count);
     // Transfer the data
-    SPIDRV_MTransferB(this->sl_spidrv_handle, tx_buf, rx_buf, current_transfer_size);
+    SPIDRV_MTransferB(this->sl_spidrv_handle, (uint8_t*)tx_buf + bytes_transferred, (uint8_t*)rx_buf + bytes_transferred, current_transfer_size);
     // Add the transferred amount to the total transferred bytes
     bytes_transferred += current_transfer_size;
   }
@@ -181,7 +506,7 @@ void SilabsSPI::_transfer_nonblock(void* tx_buf, void* rx_buf, size_t count)
   while (bytes_transferred < count) {
     size_t current_transfer_size = get_next_dma_transfer_size(bytes_transferred, count);
     // Transfer the data
-    SPIDRV_MTransfer(this->sl_spidrv_handle, tx_buf, rx_buf, current_transfer_size, this->dma_transfer_finished_callback);
+    SPIDRV_MTransfer(this->sl_spidrv_handle, (uint8_t*)tx_buf + bytes_transferred, (uint8_t*)rx_buf + bytes_transferred, current_transfer_size, this->dma_transfer_finished_callback);
     // Try to take the mutex again - current task will be blocked here until the transfer finishes
     // The dma_transfer_finished_callback will give the mutex back and the next chunk transfer will start then
     xSemaphoreTake(this->spi_transfer_mutex, portMAX_DELAY);
@@ -204,11 +529,15 @@ uint16_t SilabsSPI::receive16()
 
 void SilabsSPI::receive(void* rx_buf, size_t count, bool block)
 {
-  if (block) {
+  bool locked = this->lock_bus();
+  if (count < this->dma_threshold) {
+    this->fifo_transfer(nullptr, (uint8_t*)rx_buf, count);
+  } else if (block) {
     this->_receive_block(rx_buf, count);
   } else {
     this->_receive_nonblock(rx_buf, count);
   }
+  this->unlock_bus(locked);
 }
 
 void SilabsSPI::_receive_block(void* rx_buf, size_t count)
@@ -218,7 +547,7 @@ void SilabsSPI::_receive_block(void* rx_buf, size_t count)
   while (bytes_received < count) {
     size_t current_transfer_size = get_next_dma_transfer_size(bytes_received, count);
     // Receive the data
-    SPIDRV_MReceiveB(this->sl_spidrv_handle, rx_buf, current_transfer_size);
+    SPIDRV_MReceiveB(this->sl_spidrv_handle, (uint8_t*)rx_buf + bytes_received, current_transfer_size);
     // Add the transferred amount to the total transferred bytes
     bytes_received += current_transfer_size;
   }
@@ -234,7 +563,7 @@ void SilabsSPI::_receive_nonblock(void* rx_buf, size_t count)
   while (bytes_received < count) {
     size_t current_transfer_size = get_next_dma_transfer_size(bytes_received, count);
     // Receive the data
-    SPIDRV_MReceive(this->sl_spidrv_handle, rx_buf, current_transfer_size, this->dma_transfer_finished_callback);
+    SPIDRV_MReceive(this->sl_spidrv_handle, (uint8_t*)rx_buf + bytes_received, current_transfer_size, this->dma_transfer_finished_callback);
     // Try to take the mutex again - current task will be blocked here until the transfer finishes
     // The dma_transfer_finished_callback will give the mutex back and the next chunk transfer will start then
     xSemaphoreTake(this->spi_transfer_mutex, portMAX_DELAY);
@@ -247,14 +576,25 @@ void SilabsSPI::_receive_nonblock(void* rx_buf, size_t count)
 
 void SilabsSPI::endTransaction(void)
 {
+  // Continue with the jobs queued during the transaction
+  this->resume_async_jobs();
+  if (this->transaction_owner == xTaskGetCurrentTaskHandle()) {
+    this->transaction_owner = nullptr;
+  }
   xSemaphoreGive(this->spi_busy_mutex);
 }
 
 void SilabsSPI::end(void)
 {
+  if (this->follower_mode) {
+    this->end_follower();
+    return;
+  }
+  this->waitForAsyncJobs();
   this->endTransaction();
   SPIDRV_DeInit(this->sl_spidrv_handle);
   this->initialized = false;
+  this->settings_valid = false;
 }
 
 void SilabsSPI::setBitOrder(uint8_t bitOrder)
@@ -311,6 +651,428 @@ uint32_t SilabsSPI::getCurrentBusSpeed()
   return bitrate;
 }
 
+sl_status_t SilabsSPI::transferv(const spi_iovec_t* iov, size_t iovcnt, PinName cs_pin)
+{
+  if (!iov || iovcnt == 0u || !this->initialized) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  // Frames wider than 8 bits are moved as half words
+  const bool wide_frames = this->sl_spidrv_config->frameLength > 8u;
+  // Every segment takes one descriptor for each DMA_MAX_TRANSFER_SIZE bytes
+  size_t descriptor_count = 0u;
+  for (size_t i = 0u; i < iovcnt; i++) {
+    if (wide_frames && (iov[i].len & 1u)) {
+      return SL_STATUS_INVALID_PARAMETER;
+    }
+    descriptor_count += (iov[i].len + DMA_MAX_TRANSFER_SIZE - 1u) / DMA_MAX_TRANSFER_SIZE;
+  }
+  if (descriptor_count == 0u) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  if (descriptor_count > TRANSFERV_MAX_DESCRIPTORS) {
+    return SL_STATUS_WOULD_OVERFLOW;
+  }
+
+  // Wait for the async jobs and keep them off the bus until the chain is finished
+  bool locked = this->lock_bus();
+  // Take the transfer mutex - the DMA callback gives it back when the chain is finished
+  xSemaphoreTake(this->spi_transfer_mutex, portMAX_DELAY);
+  if (this->sl_spidrv_handle->state != spidrvStateIdle) {
+    xSemaphoreGive(this->spi_transfer_mutex);
+    this->unlock_bus(locked);
+    return SL_STATUS_BUSY;
+  }
+
+  volatile uint32_t* tx_data_reg = nullptr;
+  const volatile uint32_t* rx_data_reg = nullptr;
+#if defined(EUSART_PRESENT)
+  if (this->is_eusart()) {
+    EUSART_TypeDef* eusart = this->sl_spidrv_handle->peripheral.eusartPort;
+    tx_data_reg = &eusart->TXDATA;
+    rx_data_reg = &eusart->RXDATA;
+    // Drop the leftover received frames
+    while (eusart->STATUS & EUSART_STATUS_RXFL) {
+      (void)eusart->RXDATA;
+    }
+  }
+#endif // EUSART_PRESENT
+#if defined(USART_PRESENT)
+  if (!this->is_eusart()) {
+    USART_TypeDef* usart = this->sl_spidrv_handle->peripheral.usartPort;
+    if (this->sl_spidrv_config->frameLength > 9u) {
+      tx_data_reg = &usart->TXDOUBLE;
+      rx_data_reg = &usart->RXDOUBLE;
+    } else if (wide_frames) {
+      tx_data_reg = &usart->TXDATAX;
+      rx_data_reg = &usart->RXDATAX;
+    } else {
+      tx_data_reg = &usart->TXDATA;
+      rx_data_reg = &usart->RXDATA;
+    }
+    usart->CMD = USART_CMD_CLEARRX;
+  }
+#endif // USART_PRESENT
+
+  // Build the chains - the receiving side reads every frame, so it finishes last
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+  this->transferv_dummy_tx = this->sl_spidrv_config->dummyTxValue;
+  size_t descriptor_index = 0u;
+  for (size_t i = 0u; i < iovcnt; i++) {
+    const uint8_t* tx_buf = (const uint8_t*)iov[i].tx_buf;
+    uint8_t* rx_buf = (uint8_t*)iov[i].rx_buf;
+    for (size_t offset = 0u; offset < iov[i].len; offset += DMA_MAX_TRANSFER_SIZE) {
+      size_t chunk_size = get_next_dma_transfer_size(offset, iov[i].len);
+      uint32_t frames = wide_frames ? chunk_size / 2u : chunk_size;
+      LDMA_Descriptor_t* tx_descriptor = &this->transferv_tx_descriptors[descriptor_index];
+      LDMA_Descriptor_t* rx_descriptor = &this->transferv_rx_descriptors[descriptor_index];
+
+      *tx_descriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(tx_buf ? (const void*)(tx_buf + offset) : (const void*)&this->transferv_dummy_tx, tx_data_reg, frames, 1);
+      *rx_descriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(rx_data_reg, rx_buf ? (void*)(rx_buf + offset) : (void*)&this->transferv_dummy_rx, frames, 1);
+      if (!tx_buf) {
+        tx_descriptor->xfer.srcInc = ldmaCtrlSrcIncNone;
+      }
+      if (!rx_buf) {
+        rx_descriptor->xfer.dstInc = ldmaCtrlDstIncNone;
+      }
+      if (wide_frames) {
+        tx_descriptor->xfer.size = ldmaCtrlSizeHalf;
+        rx_descriptor->xfer.size = ldmaCtrlSizeHalf;
+      }
+      tx_descriptor->xfer.doneIfs = 0;
+      rx_descriptor->xfer.doneIfs = 0;
+      descriptor_index++;
+    }
+  }
+  #pragma GCC diagnostic pop
+  // End the chains - only the end of the receiving side raises an interrupt
+  this->transferv_tx_descriptors[descriptor_index - 1u].xfer.link = 0;
+  this->transferv_rx_descriptors[descriptor_index - 1u].xfer.link = 0;
+  this->transferv_rx_descriptors[descriptor_index - 1u].xfer.doneIfs = 1;
+
+#if defined(SL_CATALOG_POWER_MANAGER_PRESENT)
+  // The peripheral stops in EM2 - stay in EM1 while the task waits for the transfer
+  sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
+#endif
+  if (cs_pin != PIN_NAME_NC) {
+    GPIO_PinOutClear(getSilabsPortFromArduinoPin(cs_pin), getSilabsPinFromArduinoPin(cs_pin));
+  }
+
+  LDMA_TransferCfg_t rx_transfer_cfg = LDMA_TRANSFER_CFG_PERIPHERAL((LDMA_PeripheralSignal_t)this->sl_spidrv_handle->rxDMASignal);
+  LDMA_TransferCfg_t tx_transfer_cfg = LDMA_TRANSFER_CFG_PERIPHERAL((LDMA_PeripheralSignal_t)this->sl_spidrv_handle->txDMASignal);
+  DMADRV_LdmaStartTransfer((int)this->sl_spidrv_handle->rxDMACh, &rx_transfer_cfg, &this->transferv_rx_descriptors[0], transferv_dma_finished_cb, this);
+  DMADRV_LdmaStartTransfer((int)this->sl_spidrv_handle->txDMACh, &tx_transfer_cfg, &this->transferv_tx_descriptors[0], NULL, NULL);
+  // Try to take the mutex again - current task will be blocked here until the chain finishes
+  xSemaphoreTake(this->spi_transfer_mutex, portMAX_DELAY);
+
+  if (cs_pin != PIN_NAME_NC) {
+    GPIO_PinOutSet(getSilabsPortFromArduinoPin(cs_pin), getSilabsPinFromArduinoPin(cs_pin));
+  }
+#if defined(SL_CATALOG_POWER_MANAGER_PRESENT)
+  sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
+#endif
+  // Give back the transfer mutex
+  xSemaphoreGive(this->spi_transfer_mutex);
+  this->unlock_bus(locked);
+  return SL_STATUS_OK;
+}
+
+sl_status_t SilabsSPI::beginFollower(PinName cs_pin, uint8_t data_mode)
+{
+  if (cs_pin >= PIN_NAME_MAX) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  if (this->initialized) {
+    this->end();
+  }
+
+  GPIO_Port_TypeDef cs_port = getSilabsPortFromArduinoPin(cs_pin);
+  uint32_t cs_pin_num = getSilabsPinFromArduinoPin(cs_pin);
+  // Keep the leader config intact for the next begin()
+  this->follower_config = *this->sl_spidrv_config;
+  this->follower_config.type = spidrvSlave;
+  this->follower_config.csControl = spidrvCsControlAuto;
+  this->follower_config.slaveStartMode = spidrvSlaveStartImmediate;
+  this->follower_config.frameLength = 8u;
+  this->follower_config.portCs = (sl_gpio_port_t)cs_port;
+  this->follower_config.pinCs = (uint8_t)cs_pin_num;
+  switch (data_mode) {
+    case SPI_MODE1:
+      this->follower_config.clockMode = spidrvClockMode1;
+      break;
+    case SPI_MODE2:
+      this->follower_config.clockMode = spidrvClockMode2;
+      break;
+    case SPI_MODE3:
+      this->follower_config.clockMode = spidrvClockMode3;
+      break;
+    default:
+      this->follower_config.clockMode = spidrvClockMode0;
+      break;
+  }
+  if (SPIDRV_Init(this->sl_spidrv_handle, &this->follower_config) != ECODE_EMDRV_SPIDRV_OK) {
+    return SL_STATUS_FAIL;
+  }
+  this->initialized = true;
+  this->settings_valid = false;
+  this->follower_mode = true;
+  this->follower_cs_pin = cs_pin;
+
+  // The end of the transactions is detected on the rising edge of the CS
+  this->follower_cs_interrupt = GPIOINT_CallbackRegisterExt((uint8_t)cs_pin_num, follower_cs_irq_handler, this);
+  if (this->follower_cs_interrupt == INTERRUPT_UNAVAILABLE) {
+    this->end_follower();
+    return SL_STATUS_FAIL;
+  }
+  GPIO_ExtIntConfig(cs_port, cs_pin_num, this->follower_cs_interrupt, true, false, true);
+
+#if defined(SL_CATALOG_POWER_MANAGER_PRESENT)
+  // The peripheral is not clocked in EM2
+  sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
+#endif
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  this->arm_follower_transfer();
+  CORE_EXIT_ATOMIC();
+  return SL_STATUS_OK;
+}
+
+sl_status_t SilabsSPI::beginFollower(pin_size_t cs_pin, uint8_t data_mode)
+{
+  return this->beginFollower(pinToPinName(cs_pin), data_mode);
+}
+
+sl_status_t SilabsSPI::setFollowerBuffers(const void* tx_buf, size_t tx_len, void* rx_buf, size_t rx_len)
+{
+  if (tx_len > DMA_MAX_TRANSFER_SIZE || rx_len > DMA_MAX_TRANSFER_SIZE) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  this->follower_tx_buf = (const uint8_t*)tx_buf;
+  this->follower_tx_len = tx_buf ? tx_len : 0u;
+  this->follower_rx_buf = (uint8_t*)rx_buf;
+  this->follower_rx_len = rx_buf ? rx_len : 0u;
+  // Switch to the new buffers right away if there's no transaction ongoing
+  if (this->follower_mode
+      && GPIO_PinInGet(getSilabsPortFromArduinoPin(this->follower_cs_pin), getSilabsPinFromArduinoPin(this->follower_cs_pin))) {
+    this->arm_follower_transfer();
+  }
+  CORE_EXIT_ATOMIC();
+  return SL_STATUS_OK;
+}
+
+void SilabsSPI::attachFollowerCallback(spi_follower_callback_t callback, void* user_data)
+{
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  this->follower_callback = callback;
+  this->follower_callback_user_data = user_data;
+  CORE_EXIT_ATOMIC();
+}
+
+bool SilabsSPI::isFollower()
+{
+  return this->follower_mode;
+}
+
+void SilabsSPI::follower_cs_released_cb()
+{
+  if (!this->follower_mode) {
+    return;
+  }
+  size_t rx_count = 0u;
+  if (this->follower_rx_len > 0u) {
+    int remaining = 0;
+    DMADRV_TransferRemainingCount(this->sl_spidrv_handle->rxDMACh, &remaining);
+    rx_count = this->follower_rx_len - (size_t)remaining;
+  }
+  this->stop_follower_transfer();
+  if (this->follower_callback) {
+    this->follower_callback(rx_count, this->follower_callback_user_data);
+  }
+  // Get ready for the next transaction
+  this->arm_follower_transfer();
+}
+
+// Called with interrupts disabled or from an interrupt
+void SilabsSPI::arm_follower_transfer()
+{
+  this->stop_follower_transfer();
+
+  volatile uint32_t* tx_data_reg = nullptr;
+  const volatile uint32_t* rx_data_reg = nullptr;
+  // Drop the leftovers of the previous transaction
+#if defined(EUSART_PRESENT)
+  if (this->is_eusart()) {
+    EUSART_TypeDef* eusart = this->sl_spidrv_handle->peripheral.eusartPort;
+    tx_data_reg = &eusart->TXDATA;
+    rx_data_reg = &eusart->RXDATA;
+    eusart->CMD = EUSART_CMD_CLEARTX;
+    while (eusart->STATUS & EUSART_STATUS_RXFL) {
+      (void)eusart->RXDATA;
+    }
+  }
+#endif // EUSART_PRESENT
+#if defined(USART_PRESENT)
+  if (!this->is_eusart()) {
+    USART_TypeDef* usart = this->sl_spidrv_handle->peripheral.usartPort;
+    tx_data_reg = &usart->TXDATA;
+    rx_data_reg = &usart->RXDATA;
+    usart->CMD = USART_CMD_CLEARTX | USART_CMD_CLEARRX;
+  }
+#endif // USART_PRESENT
+
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+  this->transferv_dummy_tx = this->follower_config.dummyTxValue;
+  // The transmit buffer is followed by dummy bytes until the CS is released
+  this->follower_tx_descriptors[1] = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(&this->transferv_dummy_tx, tx_data_reg, DMA_MAX_TRANSFER_SIZE, 0);
+  this->follower_tx_descriptors[1].xfer.srcInc = ldmaCtrlSrcIncNone;
+  this->follower_tx_descriptors[1].xfer.doneIfs = 0;
+  LDMA_Descriptor_t* first_tx_descriptor = &this->follower_tx_descriptors[1];
+  if (this->follower_tx_len > 0u) {
+    this->follower_tx_descriptors[0] = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_M2P_BYTE(this->follower_tx_buf, tx_data_reg, this->follower_tx_len, 1);
+    this->follower_tx_descriptors[0].xfer.doneIfs = 0;
+    first_tx_descriptor = &this->follower_tx_descriptors[0];
+  }
+
+  if (this->follower_rx_len > 0u) {
+    this->follower_rx_descriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_SINGLE_P2M_BYTE(rx_data_reg, this->follower_rx_buf, this->follower_rx_len);
+  } else {
+    // Drop the received bytes until the CS is released
+    this->follower_rx_descriptor = (LDMA_Descriptor_t)LDMA_DESCRIPTOR_LINKREL_P2M_BYTE(rx_data_reg, &this->transferv_dummy_rx, DMA_MAX_TRANSFER_SIZE, 0);
+    this->follower_rx_descriptor.xfer.dstInc = ldmaCtrlDstIncNone;
+  }
+  #pragma GCC diagnostic pop
+  this->follower_rx_descriptor.xfer.doneIfs = 0;
+
+  LDMA_TransferCfg_t rx_transfer_cfg = LDMA_TRANSFER_CFG_PERIPHERAL((LDMA_PeripheralSignal_t)this->sl_spidrv_handle->rxDMASignal);
+  LDMA_TransferCfg_t tx_transfer_cfg = LDMA_TRANSFER_CFG_PERIPHERAL((LDMA_PeripheralSignal_t)this->sl_spidrv_handle->txDMASignal);
+  DMADRV_LdmaStartTransfer((int)this->sl_spidrv_handle->rxDMACh, &rx_transfer_cfg, &this->follower_rx_descriptor, NULL, NULL);
+  DMADRV_LdmaStartTransfer((int)this->sl_spidrv_handle->txDMACh, &tx_transfer_cfg, first_tx_descriptor, NULL, NULL);
+}
+
+void SilabsSPI::stop_follower_transfer()
+{
+  DMADRV_StopTransfer(this->sl_spidrv_handle->rxDMACh);
+  DMADRV_StopTransfer(this->sl_spidrv_handle->txDMACh);
+}
+
+void SilabsSPI::end_follower()
+{
+  if (this->follower_cs_interrupt != INTERRUPT_UNAVAILABLE) {
+    GPIO_ExtIntConfig(getSilabsPortFromArduinoPin(this->follower_cs_pin),
+                      getSilabsPinFromArduinoPin(this->follower_cs_pin),
+                      this->follower_cs_interrupt,
+                      false,
+                      false,
+                      false);
+    GPIOINT_CallbackUnRegister((uint8_t)this->follower_cs_interrupt);
+    this->follower_cs_interrupt = INTERRUPT_UNAVAILABLE;
+#if defined(SL_CATALOG_POWER_MANAGER_PRESENT)
+    sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
+#endif
+  }
+  this->follower_mode = false;
+  this->stop_follower_transfer();
+  SPIDRV_DeInit(this->sl_spidrv_handle);
+  this->initialized = false;
+  this->settings_valid = false;
+}
+
+void SilabsSPI::setDmaThreshold(size_t threshold)
+{
+  this->dma_threshold = threshold;
+}
+
+size_t SilabsSPI::getDmaThreshold()
+{
+  return this->dma_threshold;
+}
+
+// Keeps the transmit side one frame ahead, so the clock runs without gaps between the frames
+// Frames wider than 8 bits take two bytes from the buffers - the caller holds the bus lock
+void SilabsSPI::fifo_transfer(const uint8_t* tx_buf, uint8_t* rx_buf, size_t count)
+{
+  const bool wide_frames = this->sl_spidrv_config->frameLength > 8u;
+  const size_t frames = wide_frames ? count / 2u : count;
+  if (frames == 0u) {
+    return;
+  }
+  const uint16_t dummy_tx = (uint16_t)this->sl_spidrv_config->dummyTxValue;
+  const uint16_t* tx_words = (const uint16_t*)tx_buf;
+  uint16_t* rx_words = (uint16_t*)rx_buf;
+  // Frames written to the transmitter but not yet read from the receiver
+  const size_t max_in_flight = 2u;
+  size_t tx_count = 0u;
+  size_t rx_count = 0u;
+  uint16_t tx_data;
+  uint16_t rx_data;
+
+#if defined(EUSART_PRESENT)
+  if (this->is_eusart()) {
+    EUSART_TypeDef* eusart = this->sl_spidrv_handle->peripheral.eusartPort;
+    while (rx_count < frames) {
+      if (tx_count < frames && (tx_count - rx_count) < max_in_flight && (eusart->STATUS & EUSART_STATUS_TXFL)) {
+        if (!tx_buf) {
+          tx_data = dummy_tx;
+        } else {
+          tx_data = wide_frames ? tx_words[tx_count] : tx_buf[tx_count];
+        }
+        eusart->TXDATA = tx_data;
+        tx_count++;
+      }
+      if (eusart->STATUS & EUSART_STATUS_RXFL) {
+        rx_data = (uint16_t)eusart->RXDATA;
+        if (rx_buf && wide_frames) {
+          rx_words[rx_count] = rx_data;
+        } else if (rx_buf) {
+          rx_buf[rx_count] = (uint8_t)rx_data;
+        }
+        rx_count++;
+      }
+    }
+  }
+#endif // EUSART_PRESENT
+#if defined(USART_PRESENT)
+  if (!this->is_eusart()) {
+    USART_TypeDef* usart = this->sl_spidrv_handle->peripheral.usartPort;
+    // 9 bit frames go through the extended data registers, wider frames
+    // take both elements of the double buffer - one frame is in flight then
+    const bool double_frames = this->sl_spidrv_config->frameLength > 9u;
+    const size_t usart_max_in_flight = double_frames ? 1u : max_in_flight;
+    const uint32_t rx_ready = double_frames ? USART_STATUS_RXFULL : USART_STATUS_RXDATAV;
+    while (rx_count < frames) {
+      if (tx_count < frames && (tx_count - rx_count) < usart_max_in_flight && (usart->STATUS & USART_STATUS_TXBL)) {
+        if (!tx_buf) {
+          tx_data = dummy_tx;
+        } else {
+          tx_data = wide_frames ? tx_words[tx_count] : tx_buf[tx_count];
+        }
+        if (double_frames) {
+          usart->TXDOUBLE = tx_data;
+        } else {
+          usart->TXDATAX = tx_data;
+        }
+        tx_count++;
+      }
+      if (usart->STATUS & rx_ready) {
+        rx_data = double_frames ? (uint16_t)usart->RXDOUBLE : (uint16_t)(usart->RXDATAX & _USART_RXDATAX_RXDATA_MASK);
+        if (rx_buf && wide_frames) {
+          rx_words[rx_count] = rx_data;
+        } else if (rx_buf) {
+          rx_buf[rx_count] = (uint8_t)rx_data;
+        }
+        rx_count++;
+      }
+    }
+  }
+#endif // USART_PRESENT
+}
+
 size_t SilabsSPI::get_next_dma_transfer_size(size_t transferred, size_t total)
 {
   size_t remaining_bytes = total - transferred;
@@ -334,6 +1096,162 @@ void SilabsSPI::dma_transfer_finished_cb(struct SPIDRV_HandleData *handle, Ecode
   portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
+sl_status_t SilabsSPI::transferAsync(spi_async_job_t* job)
+{
+  if (!job || job->count == 0u || (!job->tx_buf && !job->rx_buf) || !this->initialized) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  job->transferred = 0u;
+  job->status = SL_STATUS_IN_PROGRESS;
+  job->done = false;
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  if (this->async_queue_len >= ASYNC_QUEUE_SIZE) {
+    CORE_EXIT_ATOMIC();
+    return SL_STATUS_FULL;
+  }
+  this->async_queue[(this->async_queue_head + this->async_queue_len) % ASYNC_QUEUE_SIZE] = job;
+  this->async_queue_len++;
+  // Start right away if the bus is free - otherwise the running job or endTransaction() starts it
+  if (this->async_current_job == nullptr && !this->async_paused
+      && xSemaphoreGetMutexHolderFromISR(this->spi_busy_mutex) == NULL) {
+    this->start_queued_async_job();
+  }
+  CORE_EXIT_ATOMIC();
+  return SL_STATUS_OK;
+}
+
+size_t SilabsSPI::getPendingAsyncJobs()
+{
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  size_t pending = this->async_queue_len + ((this->async_current_job != nullptr) ? 1u : 0u);
+  CORE_EXIT_ATOMIC();
+  return pending;
+}
+
+void SilabsSPI::waitForAsyncJobs()
+{
+  while (this->getPendingAsyncJobs() > 0u) {
+    // The semaphore might have been given by an earlier job - check the queue again after every wake up
+    xSemaphoreTake(this->async_idle_sem, pdMS_TO_TICKS(1));
+  }
+}
+
+void SilabsSPI::pause_async_jobs()
+{
+  // Called with the bus lock held - let the running job finish without starting the next one
+  while (true) {
+    CORE_DECLARE_IRQ_STATE;
+    CORE_ENTER_ATOMIC();
+    if (this->async_current_job == nullptr) {
+      CORE_EXIT_ATOMIC();
+      return;
+    }
+    this->async_paused = true;
+    CORE_EXIT_ATOMIC();
+    xSemaphoreTake(this->async_idle_sem, portMAX_DELAY);
+  }
+}
+
+void SilabsSPI::resume_async_jobs()
+{
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  this->async_paused = false;
+  if (this->async_current_job == nullptr) {
+    this->start_queued_async_job();
+  }
+  CORE_EXIT_ATOMIC();
+}
+
+// Called with interrupts disabled
+void SilabsSPI::start_queued_async_job()
+{
+  if (this->async_queue_len == 0u) {
+    return;
+  }
+  spi_async_job_t* job = this->async_queue[this->async_queue_head];
+  this->async_queue_head = (this->async_queue_head + 1u) % ASYNC_QUEUE_SIZE;
+  this->async_queue_len--;
+  this->start_async_job(job);
+}
+
+void SilabsSPI::start_async_job(spi_async_job_t* job)
+{
+  this->async_current_job = job;
+  // Also called from the DMA interrupt - only write the registers without querying the clock tree
+  if (job->profile && !(this->settings_valid && this->settings == job->profile->settings)) {
+    this->write_profile(*job->profile);
+  }
+  if (job->cs_pin != PIN_NAME_NC) {
+    GPIO_PinOutClear(getSilabsPortFromArduinoPin(job->cs_pin), getSilabsPinFromArduinoPin(job->cs_pin));
+  }
+  this->start_async_chunk(job);
+}
+
+void SilabsSPI::start_async_chunk(spi_async_job_t* job)
+{
+  size_t chunk_size = get_next_dma_transfer_size(job->transferred, job->count);
+  const uint8_t* tx_buf = job->tx_buf ? (const uint8_t*)job->tx_buf + job->transferred : nullptr;
+  uint8_t* rx_buf = job->rx_buf ? (uint8_t*)job->rx_buf + job->transferred : nullptr;
+
+  Ecode_t status;
+  if (tx_buf && rx_buf) {
+    status = SPIDRV_MTransfer(this->sl_spidrv_handle, tx_buf, rx_buf, chunk_size, this->async_transfer_finished_callback);
+  } else if (tx_buf) {
+    status = SPIDRV_MTransmit(this->sl_spidrv_handle, tx_buf, chunk_size, this->async_transfer_finished_callback);
+  } else {
+    status = SPIDRV_MReceive(this->sl_spidrv_handle, rx_buf, chunk_size, this->async_transfer_finished_callback);
+  }
+  // Finish the job right away if the transfer could not be started
+  if (status != ECODE_EMDRV_SPIDRV_OK) {
+    this->async_transfer_finished_cb(this->sl_spidrv_handle, status, 0);
+  }
+}
+
+void SilabsSPI::async_transfer_finished_cb(struct SPIDRV_HandleData *handle, Ecode_t transferStatus, int itemsTransferred)
+{
+  (void)handle;
+  spi_async_job_t* job = this->async_current_job;
+  if (job == nullptr) {
+    return;
+  }
+
+  job->transferred += (size_t)itemsTransferred;
+  // Continue with the next chunk of the job
+  if (transferStatus == ECODE_EMDRV_SPIDRV_OK && job->transferred < job->count) {
+    this->start_async_chunk(job);
+    return;
+  }
+
+  if (job->cs_pin != PIN_NAME_NC) {
+    GPIO_PinOutSet(getSilabsPortFromArduinoPin(job->cs_pin), getSilabsPinFromArduinoPin(job->cs_pin));
+  }
+  job->status = (transferStatus == ECODE_EMDRV_SPIDRV_OK) ? SL_STATUS_OK : SL_STATUS_TRANSMIT;
+  job->done = true;
+  if (job->callback) {
+    job->callback(job);
+  }
+
+  // Chain the next job - unless a transaction is waiting for the bus
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  this->async_current_job = nullptr;
+  if (!this->async_paused) {
+    this->start_queued_async_job();
+  }
+  bool idle = (this->async_current_job == nullptr);
+  CORE_EXIT_ATOMIC();
+
+  if (idle) {
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    xSemaphoreGiveFromISR(this->async_idle_sem, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+  }
+}
+
 void SilabsSPI::usingInterrupt(int interruptNumber)
 {
   (void)interruptNumber;
@@ -350,7 +1268,12 @@ void spi0_dma_transfer_finished_callback(struct SPIDRV_HandleData *handle, Ecode
   SPI.dma_transfer_finished_cb(handle, transferStatus, itemsTransferred);
 }
 
-arduino::SilabsSPI SPI(SL_SPIDRV_PERIPHERAL_HANDLE, &sl_spidrv_config, spi0_dma_transfer_finished_callback);
+void spi0_async_transfer_finished_callback(struct SPIDRV_HandleData *handle, Ecode_t transferStatus, int itemsTransferred)
+{
+  SPI.async_transfer_finished_cb(handle, transferStatus, itemsTransferred);
+}
+
+arduino::SilabsSPI SPI(SL_SPIDRV_PERIPHERAL_HANDLE, &sl_spidrv_config, spi0_dma_transfer_finished_callback, spi0_async_transfer_finished_callback);
 
 #if (NUM_HW_SPI > 1)
 void spi1_dma_transfer_finished_callback(struct SPIDRV_HandleData *handle, Ecode_t transferStatus, int itemsTransferred)
@@ -358,5 +1281,10 @@ void spi1_dma_transfer_finished_callback(struct SPIDRV_HandleData *handle, Ecode
   SPI1.dma_transfer_finished_cb(handle, transferStatus, itemsTransferred);
 }
 
-arduino::SilabsSPI SPI1(SL_SPIDRV1_PERIPHERAL_HANDLE, &sl_spidrv_config_spi1, spi1_dma_transfer_finished_callback);
+void spi1_async_transfer_finished_callback(struct SPIDRV_HandleData *handle, Ecode_t transferStatus, int itemsTransferred)
+{
+  SPI1.async_transfer_finished_cb(handle, transferStatus, itemsTransferred);
+}
+
+arduino::SilabsSPI SPI1(SL_SPIDRV1_PERIPHERAL_HANDLE, &sl_spidrv_config_spi1, spi1_dma_transfer_finished_callback, spi1_async_transfer_finished_callback);
 #endif // (NUM_HW_SPI > 1)
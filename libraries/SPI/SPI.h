@@ -34,14 +34,64 @@
 #include <inttypes.h>
 #include <cstddef>
 #include "spidrv.h"
+#include "dmadrv.h"
 #include "FreeRTOS.h"
 #include "semphr.h"
+#include "task.h"
 
 namespace arduino {
+// Register configuration of a device on the bus - precomputed with SilabsSPI::createProfile()
+typedef struct {
+  SPISettings settings;
+  // The peripheral clock the register values were calculated for
+  uint32_t peripheral_clock_freq;
+  // USART CLKDIV or EUSART CFG2 value
+  uint32_t clock_config;
+  // USART CTRL or EUSART CFG0 value
+  uint32_t frame_config;
+} spi_profile_t;
+
+struct spi_async_job;
+typedef void (*spi_async_callback_t)(struct spi_async_job* job);
+
+// Description of a transfer queued with SilabsSPI::transferAsync()
+// The job has to stay valid until its callback is called
+typedef struct spi_async_job {
+  // The profile of the device - nullptr keeps the current settings
+  const spi_profile_t* profile;
+  // Driven low for the duration of the transfer - PIN_NAME_NC if the CS is handled elsewhere
+  PinName cs_pin;
+  // The data to send - nullptr sends dummy bytes
+  const void* tx_buf;
+  // The received data - nullptr discards it
+  void* rx_buf;
+  size_t count;
+  // Called from an interrupt when the transfer is finished - can be nullptr
+  spi_async_callback_t callback;
+  void* user_data;
+  // Filled by the driver
+  volatile size_t transferred;
+  volatile sl_status_t status;
+  volatile bool done;
+} spi_async_job_t;
+
+// A segment of a vectored transfer - see SilabsSPI::transferv()
+typedef struct spi_iovec {
+  // The data to send - nullptr sends dummy bytes
+  const void* tx_buf;
+  // The received data - nullptr discards it
+  void* rx_buf;
+  // Length of the segment in bytes
+  size_t len;
+} spi_iovec_t;
+
+// Called from an interrupt when the leader releases the CS in follower mode
+typedef void (*spi_follower_callback_t)(size_t rx_count, void* user_data);
+
 class SilabsSPI : public SPIClass
 {
 public:
-  SilabsSPI(SPIDRV_Handle_t sl_spidrv_handle, SPIDRV_Init_t* sl_spidrv_config, SPIDRV_Callback_t dma_transfer_finished_callback);
+  SilabsSPI(SPIDRV_Handle_t sl_spidrv_handle, SPIDRV_Init_t* sl_spidrv_config, SPIDRV_Callback_t dma_transfer_finished_callback, SPIDRV_Callback_t async_transfer_finished_callback);
 
   virtual uint8_t transfer(uint8_t data);
   virtual uint16_t transfer16(uint16_t data);
@@ -62,7 +112,8 @@ public:
 
   /***************************************************************************//**
    * Transfers the provided amount of bytes on the SPI bus.
-   * Uses DMA - not recommended for small transactions.
+   * Transfers below the DMA threshold are done by polling the FIFO directly,
+   * larger ones use DMA.
    *
    * @param[in] tx_buf Pointer to the data to be transferred
    * @param[in] count Size of the data to be transferred
@@ -74,7 +125,8 @@ public:
   /***************************************************************************//**
    * Transfers the provided amount of bytes while simultaneously receiving
    * the same amount of bytes.
-   * Uses DMA - not recommended for small transactions.
+   * Transfers below the DMA threshold are done by polling the FIFO directly,
+   * larger ones use DMA.
    * Silabs specific, non-standard Arduino call.
    *
    * @param[in] tx_buf Pointer to the data to be transferred
@@ -85,6 +137,45 @@ public:
    ******************************************************************************/
   void transfer(void* tx_buf, void* rx_buf, size_t count, bool block = false);
 
+  /***************************************************************************//**
+   * Transfers an array of 16 bit words while simultaneously receiving
+   * the same amount of words.
+   * The words are sent as native 16 bit frames, MSB first with the default
+   * bit order - no byte swapping is needed e.g. for the pixels of displays.
+   * The frame length is switched to 16 bits for the transfer if needed.
+   * Transfers below the DMA threshold are done by polling the FIFO directly,
+   * larger ones use DMA.
+   * Silabs specific, non-standard Arduino call.
+   *
+   * @param[in] tx_buf Pointer to the words to be transferred - nullptr sends dummy frames
+   * @param[out] rx_buf Pointer to the array to store the received words - nullptr discards them
+   * @param[in] count Number of words to be transferred/received
+   ******************************************************************************/
+  void transfer16(const uint16_t* tx_buf, uint16_t* rx_buf, size_t count);
+
+  /***************************************************************************//**
+   * Sets the number of bits in an SPI frame.
+   * With frames wider than 8 bits transfer() and receive() send one frame
+   * for every two bytes of the buffers - the count has to be even then.
+   * transfer() and transfer16() send a single frame holding the value then,
+   * the bits above the frame length are dropped.
+   * Silabs specific, non-standard Arduino call.
+   *
+   * @param[in] bits The frame length - 8 to 16
+   *
+   * @return SL_STATUS_OK, SL_STATUS_BUSY if a transfer is ongoing or
+   *         SL_STATUS_INVALID_PARAMETER if the length is not supported
+   ******************************************************************************/
+  sl_status_t setFrameLength(uint8_t bits);
+
+  /***************************************************************************//**
+   * Returns the number of bits in an SPI frame.
+   * Silabs specific, non-standard Arduino call.
+   *
+   * @return the frame length
+   ******************************************************************************/
+  uint8_t getFrameLength();
+
   /***************************************************************************//**
    * Receives a byte on the SPI bus.
    * Silabs specific, non-standard Arduino call.
@@ -103,7 +194,8 @@ public:
 
   /***************************************************************************//**
    * Receives the provided amount of bytes on the SPI bus.
-   * Uses DMA - not recommended for small transactions.
+   * Transfers below the DMA threshold are done by polling the FIFO directly,
+   * larger ones use DMA.
    * Silabs specific, non-standard Arduino call.
    *
    * @param[out] rx_buf Pointer to the array to store the received data
@@ -121,6 +213,158 @@ public:
    ******************************************************************************/
   uint32_t getCurrentBusSpeed();
 
+  /***************************************************************************//**
+   * Transfers multiple buffers as one continuous transfer - e.g. the command
+   * header and the payload of a flash or display driver without copying them
+   * into one buffer.
+   * The segments are linked into one DMA descriptor chain, so there's no gap
+   * between them and the CS stays low for the whole transfer. Each descriptor
+   * moves at most 2048 bytes - larger segments take more descriptors.
+   * Waits for the transfer to complete, the task yields in the meantime.
+   * Silabs specific, non-standard Arduino call.
+   *
+   * @param[in] iov The segments of the transfer
+   * @param[in] iovcnt The number of segments
+   * @param[in] cs_pin Driven low for the duration of the transfer -
+   *                   PIN_NAME_NC if the CS is handled elsewhere
+   *
+   * @return SL_STATUS_OK, SL_STATUS_BUSY if the bus is in use,
+   *         SL_STATUS_WOULD_OVERFLOW if the segments need too many descriptors
+   *         or SL_STATUS_INVALID_PARAMETER if the segments are invalid
+   ******************************************************************************/
+  sl_status_t transferv(const spi_iovec_t* iov, size_t iovcnt, PinName cs_pin = PIN_NAME_NC);
+
+  /***************************************************************************//**
+   * Starts the bus in follower (slave) mode - the clock and the CS
+   * are driven by the leader, e.g. a Linux host using the board as a co-processor.
+   * The DMA moves the data between the FIFOs and the buffers set with
+   * setFollowerBuffers() - there's no CPU work per byte, the follower keeps up
+   * with the full clock speed of the leader.
+   * The device stays in EM1 while the follower mode is active.
+   * Use end() to stop the follower mode.
+   * Silabs specific, non-standard Arduino call.
+   *
+   * @param[in] cs_pin The chip select input - it has to be routable to the peripheral
+   * @param[in] data_mode The SPI mode of the leader - SPI_MODE0 to SPI_MODE3
+   *
+   * @return SL_STATUS_OK or SL_STATUS_FAIL if the follower mode couldn't be started
+   ******************************************************************************/
+  sl_status_t beginFollower(PinName cs_pin, uint8_t data_mode = SPI_MODE0);
+  sl_status_t beginFollower(pin_size_t cs_pin, uint8_t data_mode = SPI_MODE0);
+
+  /***************************************************************************//**
+   * Sets the buffers of the follower transactions.
+   * The leader reads 'tx_buf' from its start in every transaction - dummy
+   * bytes follow after the end of it. The received bytes are written into
+   * 'rx_buf' - the bytes after its end are dropped.
+   * Buffers set during a transaction take effect from the next one - they
+   * can also be set from the follower callback.
+   * Silabs specific, non-standard Arduino call.
+   *
+   * @param[in] tx_buf The data sent to the leader - nullptr sends dummy bytes
+   * @param[in] tx_len The length of the data sent to the leader
+   * @param[out] rx_buf The buffer of the received data - nullptr drops the data
+   * @param[in] rx_len The size of the receive buffer - at most 2048 bytes
+   *
+   * @return SL_STATUS_OK or SL_STATUS_INVALID_PARAMETER if a buffer is too long
+   ******************************************************************************/
+  sl_status_t setFollowerBuffers(const void* tx_buf, size_t tx_len, void* rx_buf, size_t rx_len);
+
+  /***************************************************************************//**
+   * Attaches a callback to the end of the follower transactions.
+   * The callback is called from an interrupt when the leader releases the CS.
+   * Silabs specific, non-standard Arduino call.
+   *
+   * @param[in] callback The callback - nullptr to detach it
+   * @param[in] user_data Passed to the callback
+   ******************************************************************************/
+  void attachFollowerCallback(spi_follower_callback_t callback, void* user_data = nullptr);
+
+  /***************************************************************************//**
+   * Returns whether the bus is in follower mode.
+   * Silabs specific, non-standard Arduino call.
+   *
+   * @return true if the follower mode is active
+   ******************************************************************************/
+  bool isFollower();
+
+  /***************************************************************************//**
+   * Handles the release of the CS in follower mode - called from the GPIO interrupt
+   ******************************************************************************/
+  void follower_cs_released_cb();
+
+  /***************************************************************************//**
+   * Sets the size from which the buffer transfers use DMA.
+   * Setting up a DMA transfer takes longer than clocking out a few bytes,
+   * so smaller transfers are faster by polling the FIFO of the peripheral.
+   * The best value depends on the bus speed - the spi_transfer_benchmark
+   * example measures both methods. The default of 16 bytes is an estimate
+   * which hasn't been measured on hardware yet.
+   * Silabs specific, non-standard Arduino call.
+   *
+   * @param[in] threshold The smallest transfer size in bytes done with DMA -
+   *                      0 uses DMA for every transfer
+   ******************************************************************************/
+  void setDmaThreshold(size_t threshold);
+
+  /***************************************************************************//**
+   * Returns the size from which the buffer transfers use DMA.
+   * Silabs specific, non-standard Arduino call.
+   *
+   * @return the smallest transfer size in bytes done with DMA
+   ******************************************************************************/
+  size_t getDmaThreshold();
+
+  /***************************************************************************//**
+   * Calculates the register configuration for a device on the bus.
+   * Create a profile for each device once and start its transactions with it -
+   * switching between the devices only takes a few register writes then.
+   * Silabs specific, non-standard Arduino call.
+   *
+   * @param[in] settings The SPI settings of the device - a zero clock selects the slowest one
+   *
+   * @return the profile of the device
+   ******************************************************************************/
+  spi_profile_t createProfile(SPISettings settings);
+
+  /***************************************************************************//**
+   * Starts a transaction with the settings of a precomputed profile.
+   * Silabs specific, non-standard Arduino call.
+   *
+   * @param[in] profile The profile of the device created with createProfile()
+   ******************************************************************************/
+  void beginTransaction(const spi_profile_t& profile);
+
+  /***************************************************************************//**
+   * Queues a transfer which runs in the background with DMA.
+   * The queued jobs run back-to-back - the next one is started from the
+   * interrupt finishing the previous one, so the calling task can keep going.
+   * Transactions started with beginTransaction() and the transfers outside of
+   * a transaction wait for the running job, the queued jobs continue after them.
+   * Can be called from the callback of a job to chain the next transfer.
+   * Silabs specific, non-standard Arduino call.
+   *
+   * @param[in] job The transfer - it has to stay valid until it's finished
+   *
+   * @return SL_STATUS_OK, SL_STATUS_FULL if the queue is full or
+   *         SL_STATUS_INVALID_PARAMETER if the job is invalid
+   ******************************************************************************/
+  sl_status_t transferAsync(spi_async_job_t* job);
+
+  /***************************************************************************//**
+   * Returns the number of queued jobs including the running one.
+   * Silabs specific, non-standard Arduino call.
+   *
+   * @return the number of unfinished jobs
+   ******************************************************************************/
+  size_t getPendingAsyncJobs();
+
+  /***************************************************************************//**
+   * Waits until all the queued jobs are finished.
+   * Silabs specific, non-standard Arduino call.
+   ******************************************************************************/
+  void waitForAsyncJobs();
+
   /***************************************************************************//**
    * Callback function - called from outside when a DMA transfer finishes
    *
@@ -130,6 +374,15 @@ public:
    ******************************************************************************/
   void dma_transfer_finished_cb(struct SPIDRV_HandleData *handle, Ecode_t transferStatus, int itemsTransferred);
 
+  /***************************************************************************//**
+   * Callback function - called from outside when a DMA transfer of an async job finishes
+   *
+   * @param[in] handle The SPIDRV device handle used to start the transfer
+   * @param[in] transferStatus The status of the transfer
+   * @param[in] itemsTransferred The number of bytes transferred
+   ******************************************************************************/
+  void async_transfer_finished_cb(struct SPIDRV_HandleData *handle, Ecode_t transferStatus, int itemsTransferred);
+
   // This function is deprecated.  New applications should use
   // beginTransaction() to configure SPI settings
   void setBitOrder(uint8_t bitOrder);
@@ -153,18 +406,85 @@ private:
   void _receive_nonblock(void* rx_buf, size_t count);
 
   static const int DMA_MAX_TRANSFER_SIZE = 2048;
+  // Placeholder default - not measured on hardware yet, tune it with the spi_transfer_benchmark example
+  static const size_t DEFAULT_DMA_THRESHOLD = 16u;
   size_t get_next_dma_transfer_size(size_t transferred, size_t total);
 
+  static const uint8_t TRANSFERV_MAX_DESCRIPTORS = 16;
+
+  void arm_follower_transfer();
+  void stop_follower_transfer();
+  void end_follower();
+
+  static const uint8_t ASYNC_QUEUE_SIZE = 8;
+  void start_async_job(spi_async_job_t* job);
+  void start_async_chunk(spi_async_job_t* job);
+  void start_queued_async_job();
+  void pause_async_jobs();
+  void resume_async_jobs();
+
+  void fifo_transfer(const uint8_t* tx_buf, uint8_t* rx_buf, size_t count);
+  bool lock_bus();
+  void unlock_bus(bool locked);
+
+  void apply_settings(SPISettings settings);
+  void apply_profile(const spi_profile_t& profile);
+  void write_profile(const spi_profile_t& profile);
+  bool is_eusart();
+  void update_peripheral_clock_freq();
+
   bool initialized;
+  // The settings applied to the peripheral - only valid if 'settings_valid' is set
   SPISettings settings = SPISettings(1000000, LSBFIRST, SPI_MODE0);
+  bool settings_valid;
+  uint32_t peripheral_clock_freq;
+  uint32_t active_clock_config;
+  uint32_t active_frame_config;
+  // Buffer transfers smaller than this are done without DMA
+  size_t dma_threshold;
+  // The task between beginTransaction() and endTransaction() - its transfers skip the transfer mutex
+  volatile TaskHandle_t transaction_owner;
 
   SPIDRV_Handle_t sl_spidrv_handle;
   SPIDRV_Init_t* sl_spidrv_config;
   SPIDRV_Callback_t dma_transfer_finished_callback;
+  SPIDRV_Callback_t async_transfer_finished_callback;
   SemaphoreHandle_t spi_transfer_mutex;
   StaticSemaphore_t spi_transfer_mutex_buf;
   SemaphoreHandle_t spi_busy_mutex;
   StaticSemaphore_t spi_busy_mutex_buf;
+
+  // Descriptor chains of transferv() - the LDMA reads them while the transfer is running
+  LDMA_Descriptor_t transferv_tx_descriptors[TRANSFERV_MAX_DESCRIPTORS];
+  LDMA_Descriptor_t transferv_rx_descriptors[TRANSFERV_MAX_DESCRIPTORS];
+  uint32_t transferv_dummy_tx;
+  uint32_t transferv_dummy_rx;
+
+  // Follower mode - the driver is initialized with a copy of the config in follower mode
+  bool follower_mode;
+  SPIDRV_Init_t follower_config;
+  PinName follower_cs_pin;
+  unsigned int follower_cs_interrupt;
+  const uint8_t* follower_tx_buf;
+  size_t follower_tx_len;
+  uint8_t* follower_rx_buf;
+  size_t follower_rx_len;
+  spi_follower_callback_t follower_callback;
+  void* follower_callback_user_data;
+  // The data of the transmit buffer followed by dummy bytes looping forever
+  LDMA_Descriptor_t follower_tx_descriptors[2];
+  LDMA_Descriptor_t follower_rx_descriptor;
+
+  // Queue of the async jobs - the running job is removed from it
+  spi_async_job_t* async_queue[ASYNC_QUEUE_SIZE];
+  uint8_t async_queue_head;
+  uint8_t async_queue_len;
+  spi_async_job_t* volatile async_current_job;
+  // Set while a transaction waits for the running job - no new job is started then
+  volatile bool async_paused;
+  // Given when the running job finishes without starting the next one
+  SemaphoreHandle_t async_idle_sem;
+  StaticSemaphore_t async_idle_sem_buf;
 };
 } // namespace arduino
 
@@ -0,0 +1,255 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2025 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "SPIDevice.h"
+#include "em_core.h"
+#include "em_gpio.h"
+
+using namespace arduino;
+
+// A task waiting for the bus - lives on the stack of the waiting task
+typedef struct spi_bus_waiter {
+  SemaphoreHandle_t turn_sem;
+  StaticSemaphore_t turn_sem_buf;
+  struct spi_bus_waiter* next;
+} spi_bus_waiter_t;
+
+// Hands the bus to the waiting tasks in the order they arrived
+struct arduino::spi_bus_arbiter {
+  SilabsSPI* bus;
+  bool busy;
+  spi_bus_waiter_t* head;
+  spi_bus_waiter_t* tail;
+};
+
+static struct spi_bus_arbiter bus_arbiters[NUM_HW_SPI];
+
+static struct spi_bus_arbiter* get_bus_arbiter(SilabsSPI* bus)
+{
+  struct spi_bus_arbiter* arbiter = nullptr;
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  for (uint8_t i = 0u; i < NUM_HW_SPI; i++) {
+    if (bus_arbiters[i].bus == bus || bus_arbiters[i].bus == nullptr) {
+      bus_arbiters[i].bus = bus;
+      arbiter = &bus_arbiters[i];
+      break;
+    }
+  }
+  CORE_EXIT_ATOMIC();
+  return arbiter;
+}
+
+// Returns whether the task had to wait for the bus
+static bool acquire_bus(struct spi_bus_arbiter* arbiter)
+{
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  if (!arbiter->busy) {
+    arbiter->busy = true;
+    CORE_EXIT_ATOMIC();
+    return false;
+  }
+  CORE_EXIT_ATOMIC();
+
+  // Queue up behind the other waiting tasks
+  spi_bus_waiter_t waiter;
+  waiter.turn_sem = xSemaphoreCreateBinaryStatic(&waiter.turn_sem_buf);
+  waiter.next = nullptr;
+  CORE_ENTER_ATOMIC();
+  if (!arbiter->busy) {
+    // The bus was released in the meantime
+    arbiter->busy = true;
+    CORE_EXIT_ATOMIC();
+    vSemaphoreDelete(waiter.turn_sem);
+    return true;
+  }
+  if (arbiter->tail) {
+    arbiter->tail->next = &waiter;
+  } else {
+    arbiter->head = &waiter;
+  }
+  arbiter->tail = &waiter;
+  CORE_EXIT_ATOMIC();
+
+  // The releasing task hands the bus over directly - 'busy' stays set
+  xSemaphoreTake(waiter.turn_sem, portMAX_DELAY);
+  vSemaphoreDelete(waiter.turn_sem);
+  return true;
+}
+
+static void release_bus(struct spi_bus_arbiter* arbiter)
+{
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  spi_bus_waiter_t* next_waiter = arbiter->head;
+  if (next_waiter) {
+    arbiter->head = next_waiter->next;
+    if (arbiter->head == nullptr) {
+      arbiter->tail = nullptr;
+    }
+  } else {
+    arbiter->busy = false;
+  }
+  CORE_EXIT_ATOMIC();
+
+  if (next_waiter) {
+    xSemaphoreGive(next_waiter->turn_sem);
+  }
+}
+
+SPIDevice::SPIDevice(SilabsSPI& spi, PinName cs_pin, SPISettings settings) :
+  spi(spi),
+  cs_pin(cs_pin),
+  settings(settings),
+  profile_valid(false),
+  cs_select_reg(nullptr),
+  cs_deselect_reg(nullptr),
+  cs_mask(0u),
+  arbiter(nullptr),
+  transaction_start_us(0u)
+{
+  this->resetStats();
+}
+
+SPIDevice::SPIDevice(SilabsSPI& spi, pin_size_t cs_pin, SPISettings settings) :
+  SPIDevice(spi, pinToPinName(cs_pin), settings)
+{
+  ;
+}
+
+void SPIDevice::begin()
+{
+  this->spi.begin();
+  this->arbiter = get_bus_arbiter(&this->spi);
+  // Calculated with the clock of the started bus
+  this->profile = this->spi.createProfile(this->settings);
+  this->profile_valid = true;
+
+  if (this->cs_pin == PIN_NAME_NC) {
+    return;
+  }
+  GPIO_Port_TypeDef port = getSilabsPortFromArduinoPin(this->cs_pin);
+  uint32_t pin = getSilabsPinFromArduinoPin(this->cs_pin);
+  this->cs_mask = 1UL << pin;
+#if defined(GPIO_HAS_SET_CLEAR)
+  this->cs_select_reg = &GPIO->P_CLR[port].DOUT;
+  this->cs_deselect_reg = &GPIO->P_SET[port].DOUT;
+#endif // GPIO_HAS_SET_CLEAR
+  GPIO_PinModeSet(port, pin, gpioModePushPull, 1u);
+}
+
+void SPIDevice::setSettings(SPISettings settings)
+{
+  this->settings = settings;
+  this->profile_valid = false;
+}
+
+void SPIDevice::beginTransaction()
+{
+  uint32_t wait_start_us = micros();
+  bool contended = (this->arbiter != nullptr) && acquire_bus(this->arbiter);
+  if (!this->profile_valid) {
+    this->profile = this->spi.createProfile(this->settings);
+    this->profile_valid = true;
+  }
+  this->spi.beginTransaction(this->profile);
+  this->select();
+  this->transaction_start_us = micros();
+
+  uint32_t wait_us = this->transaction_start_us - wait_start_us;
+  this->stats.total_wait_us += wait_us;
+  if (wait_us > this->stats.max_wait_us) {
+    this->stats.max_wait_us = wait_us;
+  }
+  if (contended) {
+    this->stats.contended_transactions++;
+  }
+}
+
+void SPIDevice::endTransaction()
+{
+  this->deselect();
+  uint32_t transaction_us = micros() - this->transaction_start_us;
+  this->stats.transactions++;
+  this->stats.total_transaction_us += transaction_us;
+  if (transaction_us > this->stats.max_transaction_us) {
+    this->stats.max_transaction_us = transaction_us;
+  }
+  this->spi.endTransaction();
+  if (this->arbiter) {
+    release_bus(this->arbiter);
+  }
+}
+
+uint8_t SPIDevice::transfer(uint8_t data)
+{
+  return this->spi.transfer(data);
+}
+
+void SPIDevice::transfer(void* tx_buf, void* rx_buf, size_t count)
+{
+  if (tx_buf && rx_buf) {
+    this->spi.transfer(tx_buf, rx_buf, count, true);
+  } else if (tx_buf) {
+    this->spi.transfer(tx_buf, count, true);
+  } else if (rx_buf) {
+    this->spi.receive(rx_buf, count, true);
+  }
+}
+
+SilabsSPI& SPIDevice::getBus()
+{
+  return this->spi;
+}
+
+spi_device_stats_t SPIDevice::getStats()
+{
+  return this->stats;
+}
+
+void SPIDevice::resetStats()
+{
+  memset(&this->stats, 0, sizeof(this->stats));
+}
+
+void SPIDevice::select()
+{
+  if (this->cs_select_reg) {
+    *this->cs_select_reg = this->cs_mask;
+  } else if (this->cs_pin != PIN_NAME_NC) {
+    GPIO_PinOutClear(getSilabsPortFromArduinoPin(this->cs_pin), getSilabsPinFromArduinoPin(this->cs_pin));
+  }
+}
+
+void SPIDevice::deselect()
+{
+  if (this->cs_deselect_reg) {
+    *this->cs_deselect_reg = this->cs_mask;
+  } else if (this->cs_pin != PIN_NAME_NC) {
+    GPIO_PinOutSet(getSilabsPortFromArduinoPin(this->cs_pin), getSilabsPinFromArduinoPin(this->cs_pin));
+  }
+}
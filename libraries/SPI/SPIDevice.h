@@ -0,0 +1,149 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2025 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Arduino.h"
+
+#ifndef SPI_DEVICE_H
+#define SPI_DEVICE_H
+
+#include "SPI.h"
+
+namespace arduino {
+struct spi_bus_arbiter;
+
+// Usage statistics of a device on the bus
+typedef struct {
+  // The number of finished transactions
+  uint32_t transactions;
+  // The number of transactions which had to wait for another device or task
+  uint32_t contended_transactions;
+  // Time spent waiting for the bus
+  uint32_t total_wait_us;
+  uint32_t max_wait_us;
+  // Time between selecting and deselecting the device
+  uint32_t total_transaction_us;
+  uint32_t max_transaction_us;
+} spi_device_stats_t;
+
+class SPIDevice
+{
+public:
+  /***************************************************************************//**
+   * Constructor for SPIDevice
+   *
+   * @param[in] spi The SPI bus of the device
+   * @param[in] cs_pin The chip select pin of the device
+   * @param[in] settings The SPI settings of the device
+   ******************************************************************************/
+  SPIDevice(SilabsSPI& spi, PinName cs_pin, SPISettings settings);
+  SPIDevice(SilabsSPI& spi, pin_size_t cs_pin, SPISettings settings);
+
+  /***************************************************************************//**
+   * Starts the bus if needed and sets up the chip select pin
+   * The register configuration of the device is precomputed here, so the
+   * transactions only take a few register writes to switch between the devices.
+   ******************************************************************************/
+  void begin();
+
+  /***************************************************************************//**
+   * Changes the SPI settings of the device
+   *
+   * @param[in] settings The new SPI settings
+   ******************************************************************************/
+  void setSettings(SPISettings settings);
+
+  /***************************************************************************//**
+   * Waits for the bus, applies the settings of the device and selects it
+   *
+   * The devices of a bus are served in the order they asked for it, so a busy
+   * high priority task can't starve the others out. The bus is held
+   * until endTransaction() - the transfers of the task are lock-free then.
+   ******************************************************************************/
+  void beginTransaction();
+
+  /***************************************************************************//**
+   * Deselects the device and hands the bus to the next waiting device
+   ******************************************************************************/
+  void endTransaction();
+
+  /***************************************************************************//**
+   * Transfers a byte to the device - only valid within a transaction
+   *
+   * @param[in] data The byte to send
+   *
+   * @return the received byte
+   ******************************************************************************/
+  uint8_t transfer(uint8_t data);
+
+  /***************************************************************************//**
+   * Transfers a buffer to the device - only valid within a transaction
+   *
+   * @param[in] tx_buf The data to send - nullptr sends dummy bytes
+   * @param[out] rx_buf The received data - nullptr discards it
+   * @param[in] count The number of bytes
+   ******************************************************************************/
+  void transfer(void* tx_buf, void* rx_buf, size_t count);
+
+  /***************************************************************************//**
+   * Returns the bus of the device - e.g. for the other transfer functions
+   *
+   * @return the SPI bus
+   ******************************************************************************/
+  SilabsSPI& getBus();
+
+  /***************************************************************************//**
+   * Returns the usage statistics of the device
+   *
+   * @return the statistics since the start or the last reset
+   ******************************************************************************/
+  spi_device_stats_t getStats();
+
+  /***************************************************************************//**
+   * Clears the usage statistics of the device
+   ******************************************************************************/
+  void resetStats();
+
+private:
+  void select();
+  void deselect();
+
+  SilabsSPI& spi;
+  PinName cs_pin;
+  SPISettings settings;
+  spi_profile_t profile;
+  bool profile_valid;
+  // Precomputed chip select registers - one store selects or deselects the device
+  volatile uint32_t* cs_select_reg;
+  volatile uint32_t* cs_deselect_reg;
+  uint32_t cs_mask;
+  // The arbiter of the bus - shared by all the devices on it
+  struct spi_bus_arbiter* arbiter;
+  uint32_t transaction_start_us;
+  spi_device_stats_t stats;
+};
+} // namespace arduino
+
+#endif // SPI_DEVICE_H
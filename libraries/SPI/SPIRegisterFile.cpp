@@ -0,0 +1,105 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2025 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "SPIRegisterFile.h"
+
+using namespace arduino;
+
+static void register_file_transaction_cb(size_t rx_count, void* user_data)
+{
+  ((SPIRegisterFile*)user_data)->handle_transaction(rx_count);
+}
+
+SPIRegisterFile::SPIRegisterFile(SilabsSPI& spi, void* registers, uint8_t size) :
+  spi(spi),
+  registers((uint8_t*)registers),
+  size(size),
+  pointer(0u),
+  write_callback(nullptr),
+  write_callback_user_data(nullptr)
+{
+  ;
+}
+
+sl_status_t SPIRegisterFile::begin(PinName cs_pin, uint8_t data_mode)
+{
+  if (!this->registers || this->size == 0u || this->size == READ_COMMAND) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  this->pointer = 0u;
+  this->spi.attachFollowerCallback(register_file_transaction_cb, this);
+  sl_status_t status = this->spi.beginFollower(cs_pin, data_mode);
+  if (status != SL_STATUS_OK) {
+    this->spi.attachFollowerCallback(nullptr);
+    return status;
+  }
+  return this->spi.setFollowerBuffers(this->registers, this->size, this->rx_buf, this->size + 1u);
+}
+
+sl_status_t SPIRegisterFile::begin(pin_size_t cs_pin, uint8_t data_mode)
+{
+  return this->begin(pinToPinName(cs_pin), data_mode);
+}
+
+void SPIRegisterFile::end()
+{
+  this->spi.end();
+  this->spi.attachFollowerCallback(nullptr);
+}
+
+void SPIRegisterFile::attachWriteCallback(spi_register_write_callback_t callback, void* user_data)
+{
+  this->write_callback = callback;
+  this->write_callback_user_data = user_data;
+}
+
+uint8_t SPIRegisterFile::getPointer()
+{
+  return this->pointer;
+}
+
+void SPIRegisterFile::handle_transaction(size_t rx_count)
+{
+  if (rx_count == 0u) {
+    return;
+  }
+  uint8_t command = this->rx_buf[0];
+  // Reads leave the pointer and the registers untouched
+  if (command == READ_COMMAND || command >= this->size) {
+    return;
+  }
+
+  this->pointer = command;
+  uint8_t write_len = (uint8_t)min(rx_count - 1u, (size_t)(this->size - command));
+  if (write_len > 0u) {
+    memcpy(this->registers + command, this->rx_buf + 1u, write_len);
+    if (this->write_callback) {
+      this->write_callback(command, write_len, this->write_callback_user_data);
+    }
+  }
+  // The next read starts from the new pointer
+  this->spi.setFollowerBuffers(this->registers + this->pointer, this->size - this->pointer, this->rx_buf, this->size + 1u);
+}
@@ -0,0 +1,116 @@
+/*
+ * This file is part of the Silicon Labs Arduino Core
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright 2025 Silicon Laboratories Inc. www.silabs.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Arduino.h"
+
+#ifndef SPI_REGISTER_FILE_H
+#define SPI_REGISTER_FILE_H
+
+#include "SPI.h"
+
+namespace arduino {
+// Called from an interrupt after the leader wrote registers
+typedef void (*spi_register_write_callback_t)(uint8_t address, uint8_t len, void* user_data);
+
+/***************************************************************************//**
+ * Emulates a memory-mapped register file on an SPI bus in follower mode.
+ *
+ * Protocol of the leader - every transaction starts with a command byte:
+ *  - [address] sets the register pointer
+ *  - [address][data...] writes the registers from the address and sets the pointer
+ *  - [SPIRegisterFile::READ_COMMAND][dummy...] reads the registers from the pointer
+ * The registers are sent from the first byte of a transaction, so reads have
+ * no turnaround time and run at the full clock of the leader. Written data
+ * is copied into the registers when the CS is released.
+ ******************************************************************************/
+class SPIRegisterFile
+{
+public:
+  /***************************************************************************//**
+   * Constructor for SPIRegisterFile
+   *
+   * @param[in] spi The SPI bus used in follower mode
+   * @param[in] registers The memory of the registers - e.g. a packed struct
+   * @param[in] size The size of the registers - at most 255 bytes
+   ******************************************************************************/
+  SPIRegisterFile(SilabsSPI& spi, void* registers, uint8_t size);
+
+  /***************************************************************************//**
+   * Starts the bus in follower mode and serves the registers
+   *
+   * @param[in] cs_pin The chip select input
+   * @param[in] data_mode The SPI mode of the leader - SPI_MODE0 to SPI_MODE3
+   *
+   * @return Status of the start process
+   ******************************************************************************/
+  sl_status_t begin(PinName cs_pin, uint8_t data_mode = SPI_MODE0);
+  sl_status_t begin(pin_size_t cs_pin, uint8_t data_mode = SPI_MODE0);
+
+  /***************************************************************************//**
+   * Stops serving the registers and the follower mode
+   ******************************************************************************/
+  void end();
+
+  /***************************************************************************//**
+   * Attaches a callback to the register writes of the leader
+   *
+   * The callback is called from an interrupt.
+   *
+   * @param[in] callback The callback - nullptr to detach it
+   * @param[in] user_data Passed to the callback
+   ******************************************************************************/
+  void attachWriteCallback(spi_register_write_callback_t callback, void* user_data = nullptr);
+
+  /***************************************************************************//**
+   * Returns the register pointer - the address the next read starts from
+   *
+   * @return the register pointer
+   ******************************************************************************/
+  uint8_t getPointer();
+
+  /***************************************************************************//**
+   * Handles the end of a transaction - called from the follower callback
+   *
+   * @param[in] rx_count The number of bytes received in the transaction
+   ******************************************************************************/
+  void handle_transaction(size_t rx_count);
+
+  // The command byte of reads - it can't be a register address
+  static const uint8_t READ_COMMAND = 0xFFu;
+
+private:
+  SilabsSPI& spi;
+  uint8_t* registers;
+  uint8_t size;
+  volatile uint8_t pointer;
+  // The command byte and the written data of the last transaction
+  uint8_t rx_buf[256];
+  spi_register_write_callback_t write_callback;
+  void* write_callback_user_data;
+};
+} // namespace arduino
+
+#endif // SPI_REGISTER_FILE_H
@@ -36,7 +36,8 @@ MicrophoneAnalog::MicrophoneAnalog(PinName data_pin, PinName enable_pin) :
   data_pin(data_pin),
   enable_pin(enable_pin),
   num_samples(0),
-  buffer(nullptr)
+  buffer(nullptr),
+  buffer16(nullptr)
 {
   ;
 }
@@ -46,7 +47,8 @@ MicrophoneAnalog::MicrophoneAnalog(PinName data_pin, PinName enable_pin) :
  ******************************************************************************/
 MicrophoneAnalog::MicrophoneAnalog(pin_size_t data_pin, pin_size_t enable_pin) :
   num_samples(0),
-  buffer(nullptr)
+  buffer(nullptr),
+  buffer16(nullptr)
 {
   this->data_pin = pinToPinName(data_pin);
   this->enable_pin = pinToPinName(enable_pin);
@@ -66,6 +68,29 @@ MicrophoneAnalog::~MicrophoneAnalog()
  * @param[in] buffer The data buffer for streaming
  ******************************************************************************/
 void MicrophoneAnalog::begin(uint32_t *buffer, uint32_t num_samples)
+{
+  this->init(buffer, num_samples, false);
+}
+
+/***************************************************************************//**
+ * Initializes the microphone with a 16-bit sample buffer
+ *
+ * The samples only take half the memory compared to a 32-bit buffer
+ *
+ * @param[in] buffer The data buffer for streaming
+ ******************************************************************************/
+void MicrophoneAnalog::begin(uint16_t *buffer, uint32_t num_samples)
+{
+  this->init(buffer, num_samples, true);
+}
+
+/***************************************************************************//**
+ * Sets up the pins and stores the sample buffer
+ *
+ * @param[in] buffer The data buffer for streaming
+ * @param[in] half_word The buffer holds 16-bit samples if true, 32-bit ones otherwise
+ ******************************************************************************/
+void MicrophoneAnalog::init(void *buffer, uint32_t num_samples, bool half_word)
 {
   if (!buffer) {
     return;
@@ -77,7 +102,8 @@ void MicrophoneAnalog::begin(uint32_t *buffer, uint32_t num_samples)
     digitalWrite(this->enable_pin, HIGH);
   }
   this->num_samples = num_samples;
-  this->buffer = buffer;
+  this->buffer = half_word ? nullptr : (uint32_t *)buffer;
+  this->buffer16 = half_word ? (uint16_t *)buffer : nullptr;
 }
 
 /***************************************************************************//**
@@ -89,6 +115,7 @@ void MicrophoneAnalog::end()
 
   this->num_samples = 0;
   this->buffer = nullptr;
+  this->buffer16 = nullptr;
 
   if (this->enable_pin != PIN_NAME_NC) {
     digitalWrite(this->enable_pin, LOW);
@@ -103,7 +130,11 @@ void MicrophoneAnalog::startSampling(void (*user_onsampling_finished_callback)()
   if (!user_onsampling_finished_callback) {
     return;
   }
-  analogReadDMA(this->data_pin, this->buffer, this->num_samples, user_onsampling_finished_callback);
+  if (this->buffer16) {
+    analogReadDMA(this->data_pin, this->buffer16, this->num_samples, user_onsampling_finished_callback);
+  } else {
+    analogReadDMA(this->data_pin, this->buffer, this->num_samples, user_onsampling_finished_callback);
+  }
 }
 
 /***************************************************************************//**
@@ -141,3 +172,21 @@ float MicrophoneAnalog::getAverage(uint32_t *buffer, uint32_t buf_size)
   }
   return sum / buf_size;
 }
+
+/***************************************************************************//**
+ * Gets the average value of the provided 16-bit samples
+ *
+ * @return The average value of the samples
+ ******************************************************************************/
+float MicrophoneAnalog::getAverage(uint16_t *buffer, uint32_t buf_size)
+{
+  if (!buffer) {
+    return 0.0f;
+  }
+
+  uint32_t sum = 0u;
+  for (uint32_t i = 0u; i < buf_size; i++) {
+    sum += buffer[i];
+  }
+  return (float)sum / buf_size;
+}
@@ -36,19 +36,24 @@ public:
   ~MicrophoneAnalog();
 
   void begin(uint32_t *buffer, uint32_t num_samples);
+  void begin(uint16_t *buffer, uint32_t num_samples);
   void end();
 
   void startSampling(void (*user_onsampling_finished_callback)());
   void stopSampling();
 
   float getAverage(uint32_t *buffer, uint32_t buf_size);
+  float getAverage(uint16_t *buffer, uint32_t buf_size);
   uint32_t getSingleSample();
 
 private:
+  void init(void *buffer, uint32_t num_samples, bool half_word);
+
   PinName data_pin;
   PinName enable_pin;
   uint32_t num_samples;
   uint32_t *buffer;
+  uint16_t *buffer16;
 };
 
 #endif
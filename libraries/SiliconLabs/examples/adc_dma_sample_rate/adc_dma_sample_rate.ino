@@ -0,0 +1,70 @@
+/*
+   ADC DMA sampling at a fixed sample rate example
+
+   The example shows how to sample analog inputs with the ADC at an exact sample rate.
+   The conversions are triggered by the ADC's own timer and the results are moved
+   to memory by DMA, so the samples are evenly spaced in time, which is
+   a requirement for FFT and digital filters.
+
+   The sketch samples A0 and A1 at 8 kHz and prints the average of both channels
+   each time the buffer is filled. It also prints the sample rate actually achieved
+   by the hardware, which may differ slightly from the requested one.
+   The ADC timer can't count long enough for rates below about 149 - 298 Hz
+   (depending on the ADC clock), sampling doesn't start at these rates.
+
+   Compatible boards:
+   - Arduino Nano Matter
+   - SparkFun Thing Plus MGM240P
+   - xG27 Dev Kit
+   - xG24 Explorer Kit
+   - xG24 Dev Kit
+   - BGM220 Explorer Kit
+   - Ezurio Lyra 24P 20dBm Dev Kit
+   - Seeed Studio XIAO MG24 (Sense)
+ */
+
+#define SAMPLE_RATE_HZ 8000u
+#define NUM_CHANNELS   2u
+#define BUFFER_SIZE    (NUM_CHANNELS * 128u)
+
+const pin_size_t channels[NUM_CHANNELS] = { A0, A1 };
+uint32_t sample_buffer[BUFFER_SIZE];
+volatile bool buffer_full = false;
+
+void on_sampling_finished();
+
+void setup()
+{
+  Serial.begin(115200);
+  // Start sampling - the samples of the channels are interleaved in the buffer
+  float achieved_rate = analogReadDMA(channels, NUM_CHANNELS, sample_buffer, BUFFER_SIZE, SAMPLE_RATE_HZ, on_sampling_finished);
+  Serial.print("Requested sample rate: ");
+  Serial.print(SAMPLE_RATE_HZ);
+  Serial.println(" Hz");
+  Serial.print("Achieved sample rate: ");
+  Serial.print(achieved_rate);
+  Serial.println(" Hz");
+}
+
+void loop()
+{
+  if (!buffer_full) {
+    return;
+  }
+
+  uint32_t sum[NUM_CHANNELS] = { 0u };
+  for (uint32_t i = 0u; i < BUFFER_SIZE; i++) {
+    sum[i % NUM_CHANNELS] += sample_buffer[i];
+  }
+  buffer_full = false;
+
+  Serial.print("A0: ");
+  Serial.print(sum[0] / (BUFFER_SIZE / NUM_CHANNELS));
+  Serial.print(" A1: ");
+  Serial.println(sum[1] / (BUFFER_SIZE / NUM_CHANNELS));
+}
+
+void on_sampling_finished()
+{
+  buffer_full = true;
+}
@@ -0,0 +1,40 @@
+/*
+   ADC millivolts example
+
+   The example shows how to read calibrated voltages without any floating point math.
+
+   analogReadMillivolts() returns the voltage on A0 using the factory calibration
+   of the ADC, the supply voltage is measured instead of assuming 3.3V.
+   analogReadDifferentialMillivolts() measures the voltage between A0 and A1 with
+   the selected analog gain - the result is negative when A1 is higher than A0.
+   The differential pins have to be an even and an odd numbered pin (e.g. PB0 and PB1),
+   choose another pair if A0 and A1 are not like that on your board.
+   Connect a potentiometer to A0 and turn it to see the readings change.
+
+   Compatible boards:
+   - Arduino Nano Matter
+   - SparkFun Thing Plus MGM240P
+   - xG27 Dev Kit
+   - xG24 Explorer Kit
+   - xG24 Dev Kit
+   - BGM220 Explorer Kit
+   - Ezurio Lyra 24P 20dBm Dev Kit
+   - Seeed Studio XIAO MG24 (Sense)
+ */
+
+void setup()
+{
+  Serial.begin(115200);
+  // Use 16 bits and hardware averaging for stable readings
+  analogReadResolution(16);
+  analogReadAveraging(4);
+}
+
+void loop()
+{
+  int single_ended_mv = analogReadMillivolts(A0);
+  int differential_mv = analogReadDifferentialMillivolts(A0, A1, AG_1X);
+
+  Serial.printf("A0: %d mV | A0-A1: %d mV\n", single_ended_mv, differential_mv);
+  delay(500);
+}
@@ -0,0 +1,70 @@
+/*
+   ADC window comparator example
+
+   The example shows how to watch an analog signal for crossing a threshold
+   without waking up the CPU for every sample.
+
+   The ADC checks A0 a hundred times a second on its own - also while the device sleeps.
+   The sketch is only notified when the voltage enters or leaves the configured window,
+   which makes it ideal for battery monitoring or sensor alarms.
+   Connect a potentiometer to A0 and turn it to see the events.
+
+   Compatible boards:
+   - Arduino Nano Matter
+   - SparkFun Thing Plus MGM240P
+   - xG27 Dev Kit
+   - xG24 Explorer Kit
+   - xG24 Dev Kit
+   - BGM220 Explorer Kit
+   - Ezurio Lyra 24P 20dBm Dev Kit
+   - Seeed Studio XIAO MG24 (Sense)
+ */
+
+#define WINDOW_LOW     1000u // 12-bit ADC counts
+#define WINDOW_HIGH    3000u // 12-bit ADC counts
+#define SAMPLE_RATE_HZ 100u
+
+volatile bool event_happened = false;
+volatile bool signal_inside = false;
+
+void on_window_event(bool inside);
+
+void setup()
+{
+  Serial.begin(115200);
+  pinMode(LED_BUILTIN, OUTPUT);
+  digitalWrite(LED_BUILTIN, LED_BUILTIN_INACTIVE);
+
+  sl_status_t status = ADC.window_comparator_start(pinToPinName(A0), WINDOW_LOW, WINDOW_HIGH, SAMPLE_RATE_HZ, on_window_event);
+  if (status != SL_STATUS_OK) {
+    Serial.println("Failed to start the window comparator");
+    return;
+  }
+  Serial.println("Window comparator started");
+}
+
+void loop()
+{
+  // The CPU sleeps here until the comparator reports an event
+  delay(1000);
+
+  if (!event_happened) {
+    return;
+  }
+  event_happened = false;
+
+  if (signal_inside) {
+    Serial.println("A0 is inside the window");
+    digitalWrite(LED_BUILTIN, LED_BUILTIN_ACTIVE);
+  } else {
+    Serial.println("A0 left the window");
+    digitalWrite(LED_BUILTIN, LED_BUILTIN_INACTIVE);
+  }
+}
+
+// Called from interrupt context when A0 enters or leaves the window
+void on_window_event(bool inside)
+{
+  signal_inside = inside;
+  event_happened = true;
+}
@@ -0,0 +1,59 @@
+/*
+   Analog pipeline filter example
+
+   The example shows how to filter an analog signal in real time from an ADC input
+   to a DAC output with a fixed, jitter free latency.
+
+   The stream timer of the DAC triggers the ADC and the DMA update of the DAC at the
+   same time, and each sample is filtered in a high priority interrupt in between.
+   Every input sample appears on the output exactly one sample period later,
+   no matter what the sketch does in the loop.
+   A0 is filtered with a 1 kHz Butterworth low-pass filter and output on DAC0.
+   The DAC outputs on the MG24 based boards are PB00 and PB01 for channel 0 and 1.
+
+   Compatible boards:
+   - Arduino Nano Matter
+   - SparkFun Thing Plus MGM240P
+   - xG24 Explorer Kit
+   - xG24 Dev Kit
+   - Ezurio Lyra 24P 20dBm Dev Kit
+   - Seeed Studio XIAO MG24 (Sense)
+ */
+
+#define SAMPLE_RATE_HZ   20000u
+#define CUTOFF_HZ        1000.0f
+
+BiquadFilter lowpass;
+
+void setup()
+{
+  Serial.begin(115200);
+  // Select the 2.5V reference voltage (feel free to change it)
+  analogReferenceDAC(DAC_VREF_2V5);
+
+  // Q = 0.7071 gives a Butterworth response
+  lowpass.set_lowpass(SAMPLE_RATE_HZ, CUTOFF_HZ, 0.7071f);
+
+  // A custom processing function can be passed instead of the filter:
+  // uint32_t process(uint32_t adc_sample) { return dac_sample; }
+  sl_status_t status = AnalogPipeline.begin(A0, DAC0, SAMPLE_RATE_HZ, &lowpass);
+  if (status != SL_STATUS_OK) {
+    Serial.println("Failed to start the analog pipeline");
+    return;
+  }
+  Serial.print("Filtering at ");
+  Serial.print(AnalogPipeline.get_sample_rate());
+  Serial.print(" Hz with a latency of ");
+  Serial.print(AnalogPipeline.get_latency_samples());
+  Serial.println(" sample(s)");
+}
+
+void loop()
+{
+  // The filtering runs in the background
+  delay(1000);
+  Serial.print("Processed samples: ");
+  Serial.print(AnalogPipeline.get_processed_count());
+  Serial.print(", overruns: ");
+  Serial.println(AnalogPipeline.get_overrun_count());
+}
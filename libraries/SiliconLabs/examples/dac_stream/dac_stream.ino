@@ -0,0 +1,90 @@
+/*
+   DAC stream example
+
+   The example shows how to generate waveforms with the DAC without the CPU
+   having to write every sample.
+
+   A hardware timer paces the samples and the DMA moves them to the DAC, so the
+   output rate is exact and independent from what the sketch does.
+   Channel 0 of DAC0 loops a sawtooth table forever without any CPU involvement.
+   Channel 1 plays a triangle wave from a ping-pong buffer - one half of the buffer
+   is refilled in a callback while the other half is playing.
+   The DAC outputs on the MG24 based boards are PB00 and PB01 for channel 0 and 1.
+
+   Compatible boards:
+   - Arduino Nano Matter
+   - SparkFun Thing Plus MGM240P
+   - xG24 Explorer Kit
+   - xG24 Dev Kit
+   - Ezurio Lyra 24P 20dBm Dev Kit
+   - Seeed Studio XIAO MG24 (Sense)
+ */
+
+#define SAMPLE_RATE_HZ   25600u
+#define TABLE_SIZE       256u  // 100 Hz sawtooth at 25.6 kHz
+#define BUFFER_SIZE      128u
+#define TRIANGLE_STEP    32u   // 12-bit DAC counts per sample
+
+uint32_t sawtooth_table[TABLE_SIZE];
+uint32_t triangle_buffer[BUFFER_SIZE];
+
+void fill_triangle(uint32_t *samples, uint32_t len);
+void on_triangle_half_played(uint32_t *half_buffer, uint32_t half_len);
+
+void setup()
+{
+  Serial.begin(115200);
+  // Select the 1.25V reference voltage (feel free to change it)
+  analogReferenceDAC(DAC_VREF_1V25);
+
+  // The stream samples are always 12-bit values
+  for (uint32_t i = 0u; i < TABLE_SIZE; i++) {
+    sawtooth_table[i] = (i * 4095u) / (TABLE_SIZE - 1u);
+  }
+  fill_triangle(triangle_buffer, BUFFER_SIZE);
+
+  sl_status_t status = DAC_0.stream(0, sawtooth_table, TABLE_SIZE, SAMPLE_RATE_HZ);
+  if (status == SL_STATUS_OK) {
+    status = DAC_0.stream(1, triangle_buffer, BUFFER_SIZE, SAMPLE_RATE_HZ, on_triangle_half_played);
+  }
+  if (status != SL_STATUS_OK) {
+    Serial.println("Failed to start the DAC streams");
+    return;
+  }
+  Serial.print("DAC streaming at ");
+  Serial.print(DAC_0.get_stream_sample_rate());
+  Serial.println(" Hz");
+}
+
+void loop()
+{
+  // The waveforms are generated in the background
+  delay(1000);
+}
+
+// Generates the next samples of the triangle wave
+void fill_triangle(uint32_t *samples, uint32_t len)
+{
+  static uint32_t value = 0u;
+  static bool rising = true;
+  for (uint32_t i = 0u; i < len; i++) {
+    samples[i] = value;
+    if (rising) {
+      value += TRIANGLE_STEP;
+      if (value >= 4095u - TRIANGLE_STEP) {
+        rising = false;
+      }
+    } else {
+      value -= TRIANGLE_STEP;
+      if (value < TRIANGLE_STEP) {
+        rising = true;
+      }
+    }
+  }
+}
+
+// Called from interrupt context when one half of the buffer has been played
+void on_triangle_half_played(uint32_t *half_buffer, uint32_t half_len)
+{
+  fill_triangle(half_buffer, half_len);
+}
@@ -0,0 +1,66 @@
+/*
+   Pulse counter example
+
+   The example shows how to count pulses with the hardware pulse counter (PCNT).
+   The input pin clocks the counter directly, so there's no interrupt per pulse -
+   signals up to the MHz range can be counted without any CPU load, even in EM2.
+
+   A tone on D1 provides the test signal - connect D1 to D0 with a jumper wire,
+   or connect your own signal (e.g. a flow meter) to D0.
+   The sketch prints the counted pulses and the measured frequency every second
+   and toggles the built-in LED after every 1000 pulses from the overflow callback.
+
+   Compatible boards:
+   - Arduino Nano Matter
+   - SparkFun Thing Plus MGM240P
+   - xG24 Explorer Kit
+   - xG24 Dev Kit
+   - Ezurio Lyra 24P 20dBm Dev Kit
+   - Seeed Studio XIAO MG24 (Sense)
+ */
+
+#define COUNTER_INPUT_PIN   D0
+#define TEST_SIGNAL_PIN     D1
+#define PULSES_PER_CALLBACK 1000u
+
+volatile uint32_t callback_count = 0u;
+bool led_on = false;
+
+// Called from an interrupt every time the hardware counter wraps
+void thousand_pulses_counted()
+{
+  callback_count++;
+  led_on = !led_on;
+  if (led_on) {
+    digitalWrite(LED_BUILTIN, LED_BUILTIN_ACTIVE);
+  } else {
+    digitalWrite(LED_BUILTIN, LED_BUILTIN_INACTIVE);
+  }
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  pinMode(LED_BUILTIN, OUTPUT);
+  digitalWrite(LED_BUILTIN, LED_BUILTIN_INACTIVE);
+
+  // Generate a 10 kHz test signal
+  tone(TEST_SIGNAL_PIN, 10000);
+
+  // Wrap the hardware counter after every 1000 pulses
+  PulseCounter.set_top(PULSES_PER_CALLBACK - 1u);
+  PulseCounter.attach_overflow_callback(thousand_pulses_counted);
+  sl_status_t status = PulseCounter.begin(COUNTER_INPUT_PIN, RISING);
+  if (status != SL_STATUS_OK) {
+    Serial.printf("Starting the pulse counter failed: 0x%lx\n", status);
+  }
+}
+
+void loop()
+{
+  static int32_t last_count = 0;
+  delay(1000);
+  int32_t count = PulseCounter.get_count();
+  Serial.printf("Pulses: %ld | Frequency: %ld Hz | Callbacks: %lu\n", count, count - last_count, callback_count);
+  last_count = count;
+}
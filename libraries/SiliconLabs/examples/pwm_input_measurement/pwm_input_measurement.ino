@@ -0,0 +1,45 @@
+/*
+   PWM input measurement example
+
+   The example shows how to measure the frequency and duty cycle of a signal
+   with a hardware timer - e.g. the output of a humidity sensor or an anemometer.
+   The timer captures the period and the pulse width on every edge and the DMA
+   stores them in a small ring buffer, so the measurement has no CPU cost per edge.
+   The averaged results are calculated only when they're requested.
+
+   A 25% duty cycle PWM on D1 provides the test signal - connect D1 to D0 with
+   a jumper wire, or connect your own signal to D0.
+
+   Compatible with all Silicon Labs Arduino boards.
+ */
+
+#define MEASURED_PIN     D0
+#define TEST_SIGNAL_PIN  D1
+
+PwmIn pwm_in;
+
+void setup()
+{
+  Serial.begin(115200);
+
+  // Output a 25% duty cycle test signal
+  analogWrite(TEST_SIGNAL_PIN, 64);
+
+  // Measure signals down to 10 Hz
+  sl_status_t status = pwm_in.begin(MEASURED_PIN, 10.0f);
+  if (status != SL_STATUS_OK) {
+    Serial.printf("Starting the measurement failed: 0x%lx\n", status);
+  }
+}
+
+void loop()
+{
+  Serial.print("Frequency: ");
+  Serial.print(pwm_in.get_frequency());
+  Serial.print(" Hz | Duty cycle: ");
+  Serial.print(pwm_in.get_duty_cycle());
+  Serial.print(" % | Pulse width: ");
+  Serial.print(pwm_in.get_pulse_width_us());
+  Serial.println(" us");
+  delay(1000);
+}
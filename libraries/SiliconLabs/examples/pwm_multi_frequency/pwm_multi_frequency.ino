@@ -0,0 +1,54 @@
+/*
+   PWM multi frequency example
+
+   The example shows how to output PWM signals with different frequencies at the same time.
+   Pins with the same frequency share a hardware timer, pins with different frequencies
+   get a timer of their own - so a servo, a dimmed LED and a buzzer don't affect each other.
+
+   D1 drives a hobby servo with 50 Hz pulses sweeping between 1 ms and 2 ms.
+   The built-in LED is faded with the default 1 kHz PWM frequency.
+   D2 plays a tone on a buzzer every few seconds.
+
+   Compatible with all Silicon Labs Arduino boards.
+ */
+
+#define SERVO_PIN           D1
+#define BUZZER_PIN          D2
+#define SERVO_FREQUENCY_HZ  50
+
+// The servo pulse width in 16-bit duty cycle units - 1 ms and 2 ms of the 20 ms period
+#define SERVO_MIN_DUTY      3277
+#define SERVO_MAX_DUTY      6554
+
+void setup()
+{
+  Serial.begin(115200);
+  analogWriteResolution(16);
+  Serial.print("Effective servo resolution: ");
+  Serial.print(PWM.duty_cycle_mode_get_effective_resolution(SERVO_FREQUENCY_HZ));
+  Serial.println(" bits");
+}
+
+void loop()
+{
+  static uint32_t step = 0u;
+
+  // Sweep the servo back and forth
+  uint32_t sweep = step % 200u;
+  if (sweep >= 100u) {
+    sweep = 200u - sweep;
+  }
+  int servo_duty = SERVO_MIN_DUTY + (int)(((SERVO_MAX_DUTY - SERVO_MIN_DUTY) * sweep) / 100u);
+  PWM.duty_cycle_mode(pinToPinName(SERVO_PIN), servo_duty, SERVO_FREQUENCY_HZ);
+
+  // Fade the LED on its own timer
+  analogWrite(LED_BUILTIN, (int)((sweep * 65535u) / 100u));
+
+  // Beep without disturbing the other outputs
+  if (step % 300u == 0u) {
+    tone(BUZZER_PIN, 2000, 100);
+  }
+
+  step++;
+  delay(20);
+}
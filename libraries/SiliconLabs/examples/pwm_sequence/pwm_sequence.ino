@@ -0,0 +1,60 @@
+/*
+   PWM sequence example
+
+   The example shows how to play a sequence of PWM duty cycles without any CPU involvement.
+   The LDMA writes a new compare value to the timer in every PWM period, so the
+   waveform stays smooth no matter what the sketch is doing.
+
+   The built-in LED 'breathes' endlessly with a one second long fade in and out
+   played from a table - and it blinks three times with a short sequence on button press.
+
+   Compatible with all Silicon Labs Arduino boards.
+ */
+
+#define SEQUENCE_LEN  1000u // 1 second at the default 1 kHz PWM frequency
+
+uint16_t breathe_sequence[SEQUENCE_LEN];
+volatile bool sequence_ended = false;
+
+void blink_ended(PinName pin)
+{
+  (void)pin;
+  sequence_ended = true;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+
+  // The compare values are in timer counts - one period is this many counts long
+  uint32_t period = PWM.get_sequence_period();
+  for (uint32_t i = 0u; i < SEQUENCE_LEN; i++) {
+    float brightness = (1.0f - cosf(2.0f * 3.14159f * i / SEQUENCE_LEN)) / 2.0f;
+    // Square the brightness to make the fade look linear to the eye
+    breathe_sequence[i] = (uint16_t)(brightness * brightness * (period - 1u));
+  }
+
+  // Loop the sequence until it's stopped
+  PWM.play_sequence(pinToPinName(LED_BUILTIN), breathe_sequence, SEQUENCE_LEN, 0u);
+  Serial.println("Breathing...");
+
+  #ifdef BTN_BUILTIN
+  pinMode(BTN_BUILTIN, INPUT_PULLUP);
+  #endif // BTN_BUILTIN
+}
+
+void loop()
+{
+  #ifdef BTN_BUILTIN
+  if (digitalRead(BTN_BUILTIN) == LOW) {
+    // Blink three times from the first half of the table, then continue breathing
+    PWM.play_sequence(pinToPinName(LED_BUILTIN), breathe_sequence, SEQUENCE_LEN / 2u, 3u, blink_ended);
+    while (!sequence_ended) {
+      delay(10);
+    }
+    sequence_ended = false;
+    PWM.play_sequence(pinToPinName(LED_BUILTIN), breathe_sequence, SEQUENCE_LEN, 0u);
+  }
+  #endif // BTN_BUILTIN
+  delay(10);
+}
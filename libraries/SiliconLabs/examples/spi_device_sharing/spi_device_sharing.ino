@@ -0,0 +1,88 @@
+/*
+   SPI device sharing example
+
+   The example shows how two tasks can share the SPI bus between two devices
+   with SPIDevice. Each device owns its chip select pin and SPI settings, the
+   bus is handed to the tasks in the order they asked for it.
+   The main loop and a second FreeRTOS task keep reading their own device and
+   the usage statistics of both devices are printed every second - the number
+   of transactions, how many of them had to wait for the other device and
+   the waiting and transaction times.
+
+   Nothing needs to be connected - the received data is not checked.
+   The chip select of the sensor is the SS pin of the board. The chip select
+   of the memory is the built-in LED, so the LED shows its transactions -
+   change the pins to the ones your devices are connected to.
+
+   Compatible with all Silicon Labs Arduino boards.
+ */
+
+#include <SPIDevice.h>
+
+#define SENSOR_CS_PIN PIN_SPI_SS
+#define MEMORY_CS_PIN LED_BUILTIN
+
+SPIDevice sensor(SPI, SENSOR_CS_PIN, SPISettings(8000000, MSBFIRST, SPI_MODE0));
+SPIDevice memory(SPI, MEMORY_CS_PIN, SPISettings(1000000, MSBFIRST, SPI_MODE3));
+
+void memory_task(void* params);
+void print_stats(const char* name, SPIDevice& device);
+
+void setup()
+{
+  Serial.begin(115200);
+  sensor.begin();
+  memory.begin();
+  xTaskCreate(memory_task, "memory_task", 512, nullptr, tskIDLE_PRIORITY + 1, nullptr);
+}
+
+void loop()
+{
+  static uint32_t last_print = 0;
+
+  // Read a few registers of the sensor
+  uint8_t registers[6];
+  sensor.beginTransaction();
+  sensor.transfer(0x80 | 0x28);
+  sensor.transfer(nullptr, registers, sizeof(registers));
+  sensor.endTransaction();
+
+  if (millis() - last_print > 1000) {
+    last_print = millis();
+    print_stats("Sensor", sensor);
+    print_stats("Memory", memory);
+    Serial.println();
+  }
+  delay(1);
+}
+
+// Reads a page of the memory over and over
+void memory_task(void* params)
+{
+  (void)params;
+  static uint8_t page[256];
+  while (true) {
+    memory.beginTransaction();
+    memory.transfer(0x03);
+    memory.transfer(0x00);
+    memory.transfer(0x00);
+    memory.transfer(0x00);
+    memory.transfer(nullptr, page, sizeof(page));
+    memory.endTransaction();
+    delay(2);
+  }
+}
+
+void print_stats(const char* name, SPIDevice& device)
+{
+  spi_device_stats_t stats = device.getStats();
+  uint32_t transactions = (stats.transactions > 0) ? stats.transactions : 1;
+  Serial.printf("%s: %lu transactions, %lu contended | wait avg %lu us, max %lu us | transaction avg %lu us, max %lu us\n",
+                name,
+                stats.transactions,
+                stats.contended_transactions,
+                stats.total_wait_us / transactions,
+                stats.max_wait_us,
+                stats.total_transaction_us / transactions,
+                stats.max_transaction_us);
+}
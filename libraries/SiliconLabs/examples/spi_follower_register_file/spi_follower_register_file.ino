@@ -0,0 +1,79 @@
+/*
+   SPI follower register file example
+
+   The example makes the board act as an SPI follower (slave) device with
+   a small register map - e.g. a co-processor behind a Linux host.
+   The DMA serves the registers, so the host can read and write them at the full
+   SPI clock speed without any CPU work per byte.
+
+   Every transaction of the host starts with a command byte:
+    - [address] sets the register pointer
+    - [address][data...] writes the registers from the address
+    - [0xFF][dummy...] reads the registers from the pointer
+
+   For example with spidev on a Linux host:
+    - read the whole map: write [0x00], then transfer [0xFF, 0, 0, 0, 0, 0, 0, 0]
+    - turn the LED on: write [0x04, 0x01]
+
+   Connect the SPI pins and the SS pin of the board to the host.
+
+   Compatible with all Silicon Labs Arduino boards.
+ */
+
+#include <SPIRegisterFile.h>
+
+// The register map seen by the host
+typedef struct __attribute__((packed)) {
+  uint8_t device_id;        // 0x00 - read only
+  uint8_t firmware_version; // 0x01 - read only
+  uint16_t uptime_s;        // 0x02 - read only, little endian
+  uint8_t led;              // 0x04 - written by the host
+  uint8_t scratch[3];       // 0x05
+} register_map_t;
+
+volatile register_map_t registers = { 0xA5, 1, 0, 0, { 0, 0, 0 } };
+SPIRegisterFile register_file(SPI, (void*)&registers, sizeof(registers));
+volatile bool registers_written = false;
+
+void on_registers_written(uint8_t address, uint8_t len, void* user_data);
+
+void setup()
+{
+  Serial.begin(115200);
+  pinMode(LED_BUILTIN, OUTPUT);
+
+  register_file.attachWriteCallback(on_registers_written);
+  sl_status_t status = register_file.begin(PIN_SPI_SS, SPI_MODE0);
+  if (status != SL_STATUS_OK) {
+    Serial.printf("Starting the follower mode failed: 0x%lx\n", status);
+  }
+}
+
+void loop()
+{
+  registers.uptime_s = (uint16_t)(millis() / 1000);
+
+  if (registers_written) {
+    registers_written = false;
+    if (registers.led) {
+      digitalWrite(LED_BUILTIN, LED_BUILTIN_ACTIVE);
+    } else {
+      digitalWrite(LED_BUILTIN, LED_BUILTIN_INACTIVE);
+    }
+    Serial.printf("Registers written - LED: %u, scratch: %02x %02x %02x\n",
+                  registers.led,
+                  registers.scratch[0],
+                  registers.scratch[1],
+                  registers.scratch[2]);
+  }
+  delay(10);
+}
+
+// Called from an interrupt after every write of the host
+void on_registers_written(uint8_t address, uint8_t len, void* user_data)
+{
+  (void)address;
+  (void)len;
+  (void)user_data;
+  registers_written = true;
+}
@@ -0,0 +1,73 @@
+/*
+   SPI single byte benchmark
+
+   The example measures the throughput of single byte SPI transfers - the way
+   register based drivers (e.g. for IMUs and other sensors) use the bus.
+   Inside a transaction the task owning the bus transfers the bytes without
+   taking any lock, outside of a transaction every byte takes and gives the
+   transfer mutex. The example measures both, along with transfer16().
+
+   Nothing needs to be connected - the received data is not checked.
+
+   Compatible with all Silicon Labs Arduino boards.
+ */
+
+#include <SPI.h>
+
+#define BUS_SPEED_HZ 8000000
+#define TRANSFERS    10000
+
+void print_result(const char* name, uint32_t elapsed_us, uint32_t bytes);
+
+void setup()
+{
+  Serial.begin(115200);
+  pinMode(LED_BUILTIN, OUTPUT);
+  delay(2000);
+  SPI.begin();
+}
+
+void loop()
+{
+  SPISettings settings(BUS_SPEED_HZ, MSBFIRST, SPI_MODE0);
+  uint32_t start;
+
+  // Single bytes inside one transaction - the bus is locked only once
+  SPI.beginTransaction(settings);
+  start = micros();
+  for (uint32_t i = 0; i < TRANSFERS; i++) {
+    SPI.transfer((uint8_t)i);
+  }
+  print_result("transfer() in a transaction", micros() - start, TRANSFERS);
+
+  // 16 bit words inside one transaction
+  start = micros();
+  for (uint32_t i = 0; i < TRANSFERS / 2; i++) {
+    SPI.transfer16((uint16_t)i);
+  }
+  print_result("transfer16() in a transaction", micros() - start, TRANSFERS);
+  SPI.endTransaction();
+
+  // Single bytes without a transaction - every byte takes the lock
+  start = micros();
+  for (uint32_t i = 0; i < TRANSFERS; i++) {
+    SPI.transfer((uint8_t)i);
+  }
+  print_result("transfer() without a transaction", micros() - start, TRANSFERS);
+  Serial.println();
+
+  digitalWrite(LED_BUILTIN, LED_BUILTIN_ACTIVE);
+  delay(500);
+  digitalWrite(LED_BUILTIN, LED_BUILTIN_INACTIVE);
+  delay(2500);
+}
+
+void print_result(const char* name, uint32_t elapsed_us, uint32_t bytes)
+{
+  Serial.printf("%s: %lu bytes in %lu us - %.2f us/byte, %.1f kB/s\n",
+                name,
+                bytes,
+                elapsed_us,
+                (float)elapsed_us / bytes,
+                (float)bytes * 1000.0f / elapsed_us);
+}
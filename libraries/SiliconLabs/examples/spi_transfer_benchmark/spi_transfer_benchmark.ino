@@ -0,0 +1,97 @@
+/*
+   SPI transfer benchmark
+
+   The example measures the latency and throughput of SPI buffer transfers
+   of different sizes on every SPI instance of the board - once with polling
+   the FIFO of the peripheral and once with DMA.
+   Small transfers are faster without DMA, as setting up a DMA transfer takes
+   longer than clocking out a few bytes. The example prints the smallest size
+   where DMA wins - pass it to SPI.setDmaThreshold() to tune the library for
+   your bus speed.
+
+   Nothing needs to be connected - the received data is not checked.
+
+   Compatible with all Silicon Labs Arduino boards.
+ */
+
+#include <SPI.h>
+
+#define BUS_SPEED_HZ 4000000
+#define ITERATIONS   100
+
+const size_t transfer_sizes[] = { 1, 2, 4, 8, 12, 16, 24, 32, 64, 128, 512, 2048 };
+uint8_t tx_buf[2048];
+uint8_t rx_buf[2048];
+
+void run_benchmark(arduino::SilabsSPI& spi, const char* name);
+float measure_transfer(arduino::SilabsSPI& spi, size_t size);
+
+void setup()
+{
+  Serial.begin(115200);
+  pinMode(LED_BUILTIN, OUTPUT);
+  delay(2000);
+  for (size_t i = 0; i < sizeof(tx_buf); i++) {
+    tx_buf[i] = (uint8_t)i;
+  }
+
+  run_benchmark(SPI, "SPI");
+#if (NUM_HW_SPI > 1)
+  run_benchmark(SPI1, "SPI1");
+#endif // (NUM_HW_SPI > 1)
+}
+
+void loop()
+{
+  digitalWrite(LED_BUILTIN, LED_BUILTIN_ACTIVE);
+  delay(500);
+  digitalWrite(LED_BUILTIN, LED_BUILTIN_INACTIVE);
+  delay(500);
+}
+
+// Returns the average time of a transfer in microseconds
+float measure_transfer(arduino::SilabsSPI& spi, size_t size)
+{
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < ITERATIONS; i++) {
+    spi.transfer(tx_buf, rx_buf, size, true);
+  }
+  return (float)(micros() - start) / ITERATIONS;
+}
+
+void run_benchmark(arduino::SilabsSPI& spi, const char* name)
+{
+  spi.begin();
+  spi.beginTransaction(SPISettings(BUS_SPEED_HZ, MSBFIRST, SPI_MODE0));
+  size_t default_threshold = spi.getDmaThreshold();
+  size_t dma_faster_from = 0;
+
+  Serial.printf("%s at %lu Hz, default DMA threshold: %u bytes\n", name, spi.getCurrentBusSpeed(), default_threshold);
+  Serial.println("  size | FIFO latency | FIFO throughput | DMA latency | DMA throughput");
+  for (size_t i = 0; i < sizeof(transfer_sizes) / sizeof(transfer_sizes[0]); i++) {
+    size_t size = transfer_sizes[i];
+
+    // Poll the FIFO for every size
+    spi.setDmaThreshold(SIZE_MAX);
+    float fifo_us = measure_transfer(spi, size);
+    // Use DMA for every size
+    spi.setDmaThreshold(0);
+    float dma_us = measure_transfer(spi, size);
+
+    if (dma_us < fifo_us && dma_faster_from == 0) {
+      dma_faster_from = size;
+    }
+    Serial.printf("  %4u | %9.1f us | %10.1f kB/s | %8.1f us | %9.1f kB/s\n",
+                  size,
+                  fifo_us, (float)size * 1000.0f / fifo_us,
+                  dma_us, (float)size * 1000.0f / dma_us);
+  }
+
+  if (dma_faster_from > 0) {
+    Serial.printf("DMA is faster from %u bytes\n\n", dma_faster_from);
+  } else {
+    Serial.println("DMA was not faster for any of the sizes\n");
+  }
+  spi.setDmaThreshold(default_threshold);
+  spi.endTransaction();
+}
@@ -0,0 +1,57 @@
+/*
+   Tone melody queue example
+
+   The example shows how to play a melody in the background with the tone queue.
+   The notes are queued at once and played one after the other, while the sketch
+   keeps sampling an analog input without any interruption.
+
+   Connect a passive buzzer or a speaker to D2.
+   The melody restarts every five seconds and A0 is printed to the Serial Monitor meanwhile.
+
+   Compatible with all Silicon Labs Arduino boards.
+ */
+
+#define BUZZER_PIN  D2
+
+typedef struct {
+  unsigned int frequency;
+  unsigned long duration;
+} note_t;
+
+// A rising arpeggio with a rest - a zero frequency is a rest
+const note_t melody[] = {
+  { 523, 150 }, { 659, 150 }, { 784, 150 }, { 1047, 300 },
+  { 0, 150 },
+  { 784, 150 }, { 1047, 450 }
+};
+
+void play_melody()
+{
+  for (const note_t& note : melody) {
+    toneQueue(BUZZER_PIN, note.frequency, note.duration);
+  }
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  // Short beeps are not blocking either
+  tone(BUZZER_PIN, 2000, 100);
+  delay(500);
+}
+
+void loop()
+{
+  static uint32_t last_melody_start = 0u;
+  if (toneQueueLength() == 0u && millis() - last_melody_start > 5000u) {
+    last_melody_start = millis();
+    play_melody();
+  }
+
+  // The sampling goes on while the melody plays
+  Serial.print("A0: ");
+  Serial.print(analogRead(A0));
+  Serial.print(" - notes left: ");
+  Serial.println(toneQueueLength());
+  delay(50);
+}
@@ -111,6 +111,32 @@ boards_with_dac = [
     ["lyra24p20", "ble_silabs"],
 ]
 
+boards_with_pcnt = [
+    ["nano_matter", "none"],
+    ["nano_matter", "ble_arduino"],
+    ["nano_matter", "ble_silabs"],
+    ["nano_matter", "matter"],
+    ["thingplusmatter", "none"],
+    ["thingplusmatter", "ble_arduino"],
+    ["thingplusmatter", "ble_silabs"],
+    ["thingplusmatter", "matter"],
+    ["xg24explorerkit", "none"],
+    ["xg24explorerkit", "ble_arduino"],
+    ["xg24explorerkit", "ble_silabs"],
+    ["xg24explorerkit", "matter"],
+    ["xg24devkit", "none"],
+    ["xg24devkit", "ble_arduino"],
+    ["xg24devkit", "ble_silabs"],
+    ["xg24devkit", "matter"],
+    ["lyra24p20", "none"],
+    ["lyra24p20", "ble_arduino"],
+    ["lyra24p20", "ble_silabs"],
+    ["xiao_mg24", "none"],
+    ["xiao_mg24", "ble_arduino"],
+    ["xiao_mg24", "ble_silabs"],
+    ["xiao_mg24", "matter"],
+]
+
 all_matter = [
     ["nano_matter", "matter"],
     ["thingplusmatter", "matter"],
@@ -148,6 +174,10 @@ testlist_quick = {
 
 testlist_common = {
     # Silicon Labs example library
+    "../../libraries/SiliconLabs/examples/adc_dma_sample_rate/adc_dma_sample_rate.ino":                                all_variants,
+    "../../libraries/SiliconLabs/examples/adc_millivolts/adc_millivolts.ino":                                          all_variants,
+    "../../libraries/SiliconLabs/examples/adc_window_comparator/adc_window_comparator.ino":                            all_variants,
+    "../../libraries/SiliconLabs/examples/analog_pipeline_filter/analog_pipeline_filter.ino":                          boards_with_dac,
     "../../libraries/SiliconLabs/examples/ble_blinky/ble_blinky.ino":                                                  all_ble_silabs,
     "../../libraries/SiliconLabs/examples/ble_health_thermometer/ble_health_thermometer.ino":                          all_ble_silabs,
     "../../libraries/SiliconLabs/examples/ble_health_thermometer_client/ble_health_thermometer_client.ino":            all_ble_silabs,
@@ -162,7 +192,17 @@ testlist_common = {
     "../../libraries/SiliconLabs/examples/ble_thingplus_battery_gauge/ble_thingplus_battery_gauge.ino":                thingplusmatter_ble_silabs,
     "../../libraries/SiliconLabs/examples/ble_xg27_devkit_sensors/ble_xg27_devkit_sensors.ino":                        xg27devkit_ble_silabs,
     "../../libraries/SiliconLabs/examples/dac_sawtooth/dac_sawtooth.ino":                                              boards_with_dac,
+    "../../libraries/SiliconLabs/examples/dac_stream/dac_stream.ino":                                                  boards_with_dac,
     "../../libraries/SiliconLabs/examples/hwinfo/hwinfo.ino":                                                          all_variants,
+    "../../libraries/SiliconLabs/examples/pulse_counter/pulse_counter.ino":                                            boards_with_pcnt,
+    "../../libraries/SiliconLabs/examples/pwm_input_measurement/pwm_input_measurement.ino":                            all_variants,
+    "../../libraries/SiliconLabs/examples/pwm_multi_frequency/pwm_multi_frequency.ino":                                all_variants,
+    "../../libraries/SiliconLabs/examples/pwm_sequence/pwm_sequence.ino":                                              all_variants,
+    "../../libraries/SiliconLabs/examples/spi_device_sharing/spi_device_sharing.ino":                                  all_variants,
+    "../../libraries/SiliconLabs/examples/spi_follower_register_file/spi_follower_register_file.ino":                  all_variants,
+    "../../libraries/SiliconLabs/examples/spi_single_byte_benchmark/spi_single_byte_benchmark.ino":                    all_variants,
+    "../../libraries/SiliconLabs/examples/spi_transfer_benchmark/spi_transfer_benchmark.ino":                          all_variants,
+    "../../libraries/SiliconLabs/examples/tone_melody_queue/tone_melody_queue.ino":                                    all_variants,
     "../../libraries/SiliconLabs/examples/xg27devkit_sensors/xg27devkit_sensors.ino":                                  xg27devkit_ble_silabs,
     "../../libraries/SiliconLabs/examples/thingplusmatter_debug_unix/thingplusmatter_debug_unix.ino":                  all_ble_silabs,
     "../../libraries/SiliconLabs/examples/thingplusmatter_debug_win/thingplusmatter_debug_win.ino":                    all_ble_silabs,
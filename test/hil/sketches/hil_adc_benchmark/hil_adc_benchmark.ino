@@ -0,0 +1,40 @@
+// Measures the analogRead() throughput on a single pin and on alternating pins
+
+const uint32_t benchmark_conversions = 10000u;
+
+uint32_t measure_conversions_per_second(pin_size_t pin_a, pin_size_t pin_b)
+{
+  uint32_t start = millis();
+  for (uint32_t i = 0u; i < benchmark_conversions; i += 2u) {
+    (void)analogRead(pin_a);
+    (void)analogRead(pin_b);
+  }
+  uint32_t elapsed = millis() - start;
+  if (elapsed == 0u) {
+    elapsed = 1u;
+  }
+  return (benchmark_conversions * 1000u) / elapsed;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  pinMode(LED_BUILTIN, OUTPUT);
+  digitalWrite(LED_BUILTIN, LED_BUILTIN_ACTIVE);
+}
+
+void loop()
+{
+  uint32_t single_pin = measure_conversions_per_second(A0, A0);
+  uint32_t alternating_pins = measure_conversions_per_second(A0, A1);
+  uint32_t ratio_percent = (alternating_pins * 100u) / single_pin;
+
+  Serial.printf("ADC single pin: %lu conv/s\n", single_pin);
+  Serial.printf("ADC alternating pins: %lu conv/s\n", alternating_pins);
+  if (ratio_percent >= 50u) {
+    Serial.println("ADC benchmark: OK");
+  } else {
+    Serial.println("ADC benchmark: SLOW");
+  }
+  delay(500);
+}
@@ -0,0 +1,54 @@
+// Checks that analogRead() does not disturb a timer paced analogReadDMA() stream
+
+const uint32_t stream_sample_rate_hz = 10000u;
+const uint32_t stream_buffer_size = 500u;
+const uint32_t measurement_time_ms = 2000u;
+
+uint16_t stream_buffer[stream_buffer_size];
+volatile uint32_t stream_buffers_completed = 0u;
+
+void on_stream_buffer_full()
+{
+  stream_buffers_completed++;
+}
+
+uint32_t count_stream_buffers(bool read_concurrently, uint32_t *single_reads)
+{
+  *single_reads = 0u;
+  stream_buffers_completed = 0u;
+  uint32_t start = millis();
+  while (millis() - start < measurement_time_ms) {
+    if (read_concurrently) {
+      (void)analogRead(A1);
+      (*single_reads)++;
+    } else {
+      yield();
+    }
+  }
+  return stream_buffers_completed;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  pinMode(LED_BUILTIN, OUTPUT);
+  digitalWrite(LED_BUILTIN, LED_BUILTIN_ACTIVE);
+  analogReadDMA(A0, stream_buffer, stream_buffer_size, stream_sample_rate_hz, on_stream_buffer_full);
+}
+
+void loop()
+{
+  uint32_t single_reads;
+  uint32_t idle_buffers = count_stream_buffers(false, &single_reads);
+  uint32_t concurrent_buffers = count_stream_buffers(true, &single_reads);
+  uint32_t difference = (idle_buffers > concurrent_buffers) ? (idle_buffers - concurrent_buffers) : (concurrent_buffers - idle_buffers);
+
+  Serial.printf("ADC stream buffers idle: %lu\n", idle_buffers);
+  Serial.printf("ADC stream buffers with %lu analogRead: %lu\n", single_reads, concurrent_buffers);
+  if (idle_buffers > 0u && single_reads > 0u && difference <= 1u) {
+    Serial.println("ADC concurrent: OK");
+  } else {
+    Serial.println("ADC concurrent: FAIL");
+  }
+  delay(500);
+}
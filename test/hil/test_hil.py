@@ -15,6 +15,8 @@ from testcases.testcase_hil_si7021_wire import testcase_hil_si7021_wire
 from testcases.testcase_hil_ble_silabs_advertise import testcase_hil_ble_silabs_advertise
 from testcases.testcase_hil_ble_arduino_advertise import testcase_hil_ble_arduino_advertise
 from testcases.testcase_hil_matter_smoke import testcase_hil_matter_smoke
+from testcases.testcase_hil_adc_benchmark import testcase_hil_adc_benchmark
+from testcases.testcase_hil_adc_concurrent import testcase_hil_adc_concurrent
 
 all_variants = [
     ["nano_matter", "none"],
@@ -59,6 +61,8 @@ testcase_list = {
     "ble_silabs_advertise": testcase_hil_ble_silabs_advertise,
     "ble_arduino_advertise": testcase_hil_ble_arduino_advertise,
     "matter_smoke": testcase_hil_matter_smoke,
+    "adc_benchmark": testcase_hil_adc_benchmark,
+    "adc_concurrent": testcase_hil_adc_concurrent,
 }
 
 
@@ -0,0 +1,19 @@
+import util.hil_util as hil_util
+
+def testcase_hil_adc_benchmark(current_board, variant, current_board_port):
+    """
+    Testcase: HIL ADC benchmark
+    Description: Measures the analogRead() conversions per second on a single pin and on alternating pins
+                 Switching between pins must not reinitialize the ADC, so the alternating rate has to
+                 stay within half of the single pin rate
+    """
+    did_run = True
+    success = hil_util.arduino_cli_build_and_flash(current_board, variant, "sketches/hil_adc_benchmark/hil_adc_benchmark.ino", current_board_port)
+    if not success:
+        print(f"Build/upload failed for '{variant}' on '{current_board}'")
+        return did_run, False
+    success = hil_util.check_serial_response(current_board_port, "ADC benchmark: OK")
+    if not success:
+        print(f"Serial response check failed for '{variant}' on '{current_board}'")
+        return did_run, False
+    return did_run, True
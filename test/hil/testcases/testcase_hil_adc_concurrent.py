@@ -0,0 +1,19 @@
+import util.hil_util as hil_util
+
+def testcase_hil_adc_concurrent(current_board, variant, current_board_port):
+    """
+    Testcase: HIL ADC concurrent
+    Description: Streams one pin with a timer paced analogReadDMA() and counts the completed buffers
+                 with and without analogRead() calls on another pin running at the same time
+                 The single conversions must not pause the stream, so the counts have to match
+    """
+    did_run = True
+    success = hil_util.arduino_cli_build_and_flash(current_board, variant, "sketches/hil_adc_concurrent/hil_adc_concurrent.ino", current_board_port)
+    if not success:
+        print(f"Build/upload failed for '{variant}' on '{current_board}'")
+        return did_run, False
+    success = hil_util.check_serial_response(current_board_port, "ADC concurrent: OK")
+    if not success:
+        print(f"Serial response check failed for '{variant}' on '{current_board}'")
+        return did_run, False
+    return did_run, True
@@ -0,0 +1,187 @@
+// Host-side test harness for the ADC -> DSP -> DAC pipeline processing
+// Feeds synthetic signals through the same filter code the pipeline runs
+// on the device and checks the results.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "biquad.h"
+
+using arduino::BiquadFilter;
+
+static const uint8_t resolution_bits = 12u;
+static const uint32_t max_value = (1u << resolution_bits) - 1u;
+static const uint32_t mid_scale = 1u << (resolution_bits - 1u);
+static const double pi = 3.14159265358979;
+
+static int failed_checks = 0;
+
+#define CHECK(condition, ...)                   \
+  do {                                          \
+    if (!(condition)) {                         \
+      printf("  FAIL: " __VA_ARGS__);           \
+      printf("\n");                             \
+      failed_checks++;                          \
+    }                                           \
+  } while (0)
+
+static BiquadFilter filter;
+
+// Runs the signal through the same processing stage the pipeline uses when it's started with a filter
+static std::vector<uint32_t> run_filter(const std::vector<uint32_t>& input)
+{
+  std::vector<uint32_t> output;
+  for (uint32_t sample : input) {
+    output.push_back(filter.process_unsigned(sample, resolution_bits));
+  }
+  return output;
+}
+
+static std::vector<uint32_t> make_sine(uint32_t length, double frequency_hz, double sample_rate_hz, double amplitude)
+{
+  std::vector<uint32_t> signal;
+  for (uint32_t i = 0u; i < length; i++) {
+    double value = mid_scale + amplitude * std::sin(2.0 * pi * frequency_hz * i / sample_rate_hz);
+    signal.push_back((uint32_t)std::lround(value));
+  }
+  return signal;
+}
+
+static std::vector<uint32_t> make_constant(uint32_t length, uint32_t value)
+{
+  return std::vector<uint32_t>(length, value);
+}
+
+// Returns the peak deviation from the mid scale in the second half of the signal
+static double settled_amplitude(const std::vector<uint32_t>& signal)
+{
+  double peak = 0.0;
+  for (size_t i = signal.size() / 2u; i < signal.size(); i++) {
+    double deviation = std::fabs((double)signal[i] - mid_scale);
+    if (deviation > peak) {
+      peak = deviation;
+    }
+  }
+  return peak;
+}
+
+static void test_lowpass_response()
+{
+  printf("Low-pass filter frequency response\n");
+  const double sample_rate_hz = 20000.0;
+  CHECK(filter.set_lowpass(sample_rate_hz, 1000.0f, 0.7071f), "the filter could not be configured");
+
+  filter.reset();
+  double passband = settled_amplitude(run_filter(make_sine(4000u, 100.0, sample_rate_hz, 1500.0)));
+  CHECK(std::fabs(passband - 1500.0) < 30.0, "100 Hz came out with %.1f amplitude instead of 1500", passband);
+
+  filter.reset();
+  double cutoff = settled_amplitude(run_filter(make_sine(4000u, 1000.0, sample_rate_hz, 1500.0)));
+  CHECK(std::fabs(cutoff - 1500.0 * 0.7071) < 30.0, "1 kHz came out with %.1f amplitude instead of -3dB", cutoff);
+
+  filter.reset();
+  double stopband = settled_amplitude(run_filter(make_sine(4000u, 8000.0, sample_rate_hz, 1500.0)));
+  CHECK(stopband < 1500.0 * 0.03, "8 kHz came out with %.1f amplitude - not attenuated enough", stopband);
+}
+
+static void test_highpass_blocks_dc()
+{
+  printf("High-pass filter settles to the mid scale\n");
+  CHECK(filter.set_highpass(20000.0f, 50.0f, 0.7071f), "the filter could not be configured");
+  filter.reset();
+  std::vector<uint32_t> output = run_filter(make_constant(20000u, 3500u));
+  CHECK(output.back() == mid_scale, "settled to %u instead of %u", output.back(), mid_scale);
+}
+
+static void test_low_cutoff_has_no_dc_error()
+{
+  printf("Low cutoff low-pass filter settles to the exact input\n");
+  // A very low cutoff compared to the sample rate makes the feedback coefficients close to the limits
+  CHECK(filter.set_lowpass(48000.0f, 10.0f, 0.7071f), "the filter could not be configured");
+  const uint32_t levels[] = { 1u, 1000u, 2049u, 3333u, 4094u };
+  for (uint32_t level : levels) {
+    filter.reset();
+    std::vector<uint32_t> output = run_filter(make_constant(100000u, level));
+    CHECK(output.back() == level, "settled to %u instead of %u", output.back(), level);
+  }
+}
+
+static void test_matches_floating_point()
+{
+  printf("Fixed-point filter follows the floating-point reference\n");
+  const float sample_rate_hz = 10000.0f;
+  const float center_hz = 500.0f;
+  const float q = 2.0f;
+  CHECK(filter.set_bandpass(sample_rate_hz, center_hz, q), "the filter could not be configured");
+  filter.reset();
+
+  // The reference uses the same textbook formulas in double precision
+  double w0 = 2.0 * pi * center_hz / sample_rate_hz;
+  double alpha = std::sin(w0) / (2.0 * q);
+  double a0 = 1.0 + alpha;
+  double b0 = alpha / a0, b1 = 0.0, b2 = -alpha / a0;
+  double a1 = -2.0 * std::cos(w0) / a0, a2 = (1.0 - alpha) / a0;
+  double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+
+  srand(1234);
+  double max_error = 0.0;
+  for (uint32_t i = 0u; i < 20000u; i++) {
+    int32_t x = (rand() % 4001) - 2000;
+    double y = (b0 * x) + (b1 * x1) + (b2 * x2) - (a1 * y1) - (a2 * y2);
+    x2 = x1;
+    x1 = x;
+    y2 = y1;
+    y1 = y;
+    double error = std::fabs(filter.process(x) - y);
+    if (error > max_error) {
+      max_error = error;
+    }
+  }
+  CHECK(max_error < 3.0, "the largest deviation is %.2f LSB", max_error);
+}
+
+static void test_saturation()
+{
+  printf("Overdriven filter stays within the output range\n");
+  CHECK(filter.set_bandpass(20000.0f, 1000.0f, 20.0f), "the filter could not be configured");
+  filter.reset();
+  std::vector<uint32_t> input;
+  for (uint32_t i = 0u; i < 4000u; i++) {
+    input.push_back(((i / 10u) % 2u) ? max_value : 0u);
+  }
+  bool clipped = false;
+  for (uint32_t sample : run_filter(input)) {
+    CHECK(sample <= max_value, "sample out of range: %u", sample);
+    if (sample == 0u || sample == max_value) {
+      clipped = true;
+    }
+  }
+  CHECK(clipped, "the resonance didn't reach the end of the range");
+}
+
+static void test_invalid_parameters()
+{
+  printf("Invalid filter parameters are rejected\n");
+  CHECK(!filter.set_coefficients(9.0f, 0.0f, 0.0f, 0.0f, 0.0f), "out of range coefficient accepted");
+  CHECK(!filter.set_lowpass(1000.0f, 600.0f, 0.7071f), "cutoff above Nyquist accepted");
+  CHECK(!filter.set_highpass(1000.0f, 100.0f, 0.0f), "zero Q accepted");
+  CHECK(!filter.set_notch(0.0f, 100.0f, 1.0f), "zero sample rate accepted");
+}
+
+int main()
+{
+  test_lowpass_response();
+  test_highpass_blocks_dc();
+  test_low_cutoff_has_no_dc_error();
+  test_matches_floating_point();
+  test_saturation();
+  test_invalid_parameters();
+
+  if (failed_checks > 0) {
+    printf("%d checks failed\n", failed_checks);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
@@ -0,0 +1,80 @@
+# Host tests for the Silabs Arduino Core
+# Builds and runs the hardware independent parts of the core on the host machine
+# This script assumes that you have a C++17 capable 'g++' installed
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+
+class bcolors:
+    HEADER = '\033[95m'
+    OKGREEN = '\033[92m'
+    FAIL = '\033[91m'
+    ENDC = '\033[0m'
+
+
+script_dir = os.path.dirname(os.path.abspath(__file__))
+core_dir = os.path.join(script_dir, "..", "..", "cores", "gecko")
+
+testlist = [
+    "sources/analog_pipeline/analog_pipeline.cpp",
+]
+
+compiler_flags = ["-std=gnu++17", "-O2", "-Wall", "-Wextra", "-Werror"]
+
+
+def main():
+    print(f"{bcolors.HEADER}Silabs Arduino Core host test{bcolors.ENDC}")
+    build_dir = tempfile.mkdtemp(prefix="silabs_host_test_")
+
+    failing_tests = []
+    start_time = time.time()
+
+    for test in testlist:
+        test_name = os.path.splitext(os.path.basename(test))[0]
+        print("")
+        print("-"*40)
+        print(f"Running '{test_name}'")
+        print("-"*40)
+        if not run_test(test, test_name, build_dir):
+            failing_tests.append(test_name)
+    shutil.rmtree(build_dir, ignore_errors=True)
+
+    total_time = int(time.time() - start_time)
+    print("")
+    print("-"*40)
+    print(f"Total tests: {len(testlist)}")
+    print(f"Failed tests: {len(failing_tests)}")
+    for test in failing_tests:
+        print(f"\t{test}")
+    print(f"Total time: {total_time // 60}m {total_time % 60}s")
+    print("-"*40)
+    if len(failing_tests) == 0:
+        print(f"{bcolors.OKGREEN}All tests were successful!{bcolors.ENDC}")
+        sys.exit(0)
+    print(f"{bcolors.FAIL}{len(failing_tests)} testcases failed!{bcolors.ENDC}")
+    sys.exit(1)
+
+
+def run_test(test, test_name, build_dir):
+    """
+    Compiles a test source against the core and runs it
+    """
+    executable = os.path.join(build_dir, test_name)
+    build_command = ["g++"] + compiler_flags + ["-I", core_dir, os.path.join(script_dir, test), "-o", executable, "-lm"]
+    if subprocess.run(build_command).returncode != 0:
+        print(f"{bcolors.FAIL}Building '{test_name}' failed{bcolors.ENDC}")
+        return False
+    if subprocess.run([executable]).returncode != 0:
+        print(f"{bcolors.FAIL}Testcase '{test_name}' failed{bcolors.ENDC}")
+        return False
+    print(f"{bcolors.OKGREEN}Testcase '{test_name}' successful{bcolors.ENDC}")
+    return True
+
+
+if __name__ == "__main__":
+    main()